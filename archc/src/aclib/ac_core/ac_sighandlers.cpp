@@ -39,10 +39,19 @@ void sigusr1_handler(int signal)
   fprintf(stderr, "ArchC: -------------------- Continuing Simulation ------------------\n");
 }
 
+/* Set from signal handlers, served by AC_GDB::poll() between batches. */
+volatile sig_atomic_t ac_gdb_break_request = 0;
+volatile sig_atomic_t ac_gdb_socket_ready = 0;
+
 void sigusr2_handler(int signal)
 {
-  fprintf(stderr, "ArchC: Received signal %d. Starting GDB support (not implemented).\n", signal);
-/*  gdbstub->enable();
-  gdbstub->connect();*/
+  /* Stop for GDB, enabling it first if needed. */
+  ac_gdb_break_request = 1;
+}
+
+void sigio_handler(int signal)
+{
+  /* GDB sent something, maybe a Control-C. */
+  ac_gdb_socket_ready = 1;
 }
 
@@ -17,8 +17,8 @@
  *
  * @brief     Breakpoint support
  *            This class implements breakpoint support, actually it's 
- *            just a vector that keeps crescent order of elements and 
- *            have exits() method. It should be replaced for STL in future.
+ *            just a hash set of addresses and a bitmap of the pages
+ *            that have any of them.
  *
  * @attention Copyright (C) 2002-2006 --- The ArchC Team
  *
@@ -28,26 +28,40 @@
  * \li Coding style (basically emacs style)
  * \li Commenting style. This code use doxygen (http://www.doxygen.org)
  *     to be documented.
- *
- * \todo  This class should be replaced for standard STL element.
  */
 
 #include "breakpoints.H"
 
+/** Free hash table slot. No instruction starts at this address. */
+#define EMPTY UINT_MAX
+
+
 /**
  * Constructor
  *
  * \param quant how many breakpoints to support
  */
 Breakpoints::Breakpoints(int quant) {
+  unsigned int size = 2;
+
+  /* Keep the table at most half full */
+  shift = 31;
+  while ( size < (unsigned) quant * 2 )
+    {
+      size <<= 1;
+      shift --;
+    }
+
   quantMax = quant;
-  if ( ( bp = (unsigned int *) calloc( quantMax,
-				       sizeof( unsigned int ) ) ) == NULL )
+  mask = size - 1;
+  if ( ( bp = (unsigned int *) malloc( size * sizeof( unsigned int ) ) ) == NULL )
     {
       perror( "Couldn't allocate breakpoint array." );
       quantMax = 0;
     }
-  memset( bp, 255, sizeof(unsigned int)* quantMax );
+  else
+    memset( bp, 255, sizeof(unsigned int) * size );
+  memset( pages, 0, sizeof( pages ) );
   this->quant = 0; /* no breakpoints at start up */
 }
 
@@ -62,81 +76,125 @@ Breakpoints::~Breakpoints() {
 
 
 /**
- * Add breakpoint at address
+ * Home slot of address: Fibonacci hashing, which takes the top bits of
+ * the product, where every bit of address has been mixed in.
  *
- * \param address where to put breakpoint
+ * \param address the address to hash
  *
- * \param 0 on success, -1 otherwise
+ * \return slot index
  */
-int Breakpoints::add(unsigned int address) {
-  int i, tmp;
+unsigned int Breakpoints::hash(unsigned int address) {
+  return ( address * 2654435761U ) >> shift;
+}
+
+
+/**
+ * Find the slot holding address, or the free slot where it would go.
+ *
+ * \param address the address to look for
+ *
+ * \return slot index
+ */
+unsigned int Breakpoints::slot(unsigned int address) {
+  unsigned int i;
+
+  for ( i = hash( address ); bp[ i ] != EMPTY && bp[ i ] != address; i = ( i + 1 ) & mask )
+    ;
+  return i;
+}
+
+
+/**
+ * Look address up in the hash table.
+ *
+ * \param address the address to be checked
+ *
+ * \return 1 if there is a breakpoint, 0 otherwise
+ */
+int Breakpoints::lookup(unsigned int address) {
+  if ( ! bp )
+    return 0;
+
+  return bp[ slot( address ) ] == address;
+}
 
-  if ( ( ! bp ) || ( quant >= quantMax ) )
-    return -1;
 
-  for ( i = 0; i < quant; i++ )
-    /* Insert in order */
-    if ( address < bp[i] )
+/**
+ * Recompute the page bit of address after a change.
+ *
+ * \param address any address in the page
+ */
+void Breakpoints::mark_page(unsigned int address) {
+  unsigned int i, page = address >> 12;
+  unsigned char bit = 1 << ( page & 7 );
+
+  pages[ page >> 3 ] &= ~bit;
+  for ( i = 0; i <= mask; i ++ )
+    if ( bp[ i ] != EMPTY && ( bp[ i ] >> 12 ) == page )
       {
-	tmp     = address;
-	address = bp[i];
-	bp[i]   = tmp;
+	pages[ page >> 3 ] |= bit;
+	break;
       }
-
-  bp[ quant ++ ] = address;
-  return 0;
 }
 
 
 /**
- * Remove breakpoint at address
+ * Add breakpoint at address
  *
- * \param address the address to have breakpoint removed
+ * \param address where to put breakpoint
  *
  * \param 0 on success, -1 otherwise
  */
-int Breakpoints::remove(unsigned int address) {
-  int i;
+int Breakpoints::add(unsigned int address) {
+  unsigned int i;
 
-  if ( ( ! bp ) || ( quant >= quantMax ) )
+  if ( ( ! bp ) || ( address == EMPTY ) )
     return -1;
 
-  for ( i = 0; i < quant; i ++ )
-    if ( bp[ i ] == address )
-      {
-	/* Copy remaining breakpoints: [ a | b | c ] => [ a | c ] */
-	for ( ; i < ( quant - 1 ); i ++ )
-	  bp[ i ] = bp[ i + 1 ];
-
-	quant --;
-	return 0;
-      }
+  i = slot( address );
+  if ( bp[ i ] == address )
+    return 0;
+  if ( quant >= quantMax )
+    return -1;
 
-  return -1;
+  bp[ i ] = address;
+  quant ++;
+  pages[ address >> 15 ] |= 1 << ( ( address >> 12 ) & 7 );
+  return 0;
 }
 
+
 /**
- * Check if breakpoint exists
+ * Remove breakpoint at address
  *
- * \param address the address to be checked
+ * \param address the address to have breakpoint removed
  *
- * \return 1 if there is a breakpoint, 0 otherwise
+ * \param 0 on success, -1 otherwise
  */
-int Breakpoints::exists(unsigned int address) {
-  int i;
+int Breakpoints::remove(unsigned int address) {
+  unsigned int i, j, home;
 
-  if ( ( ! bp ) || ( quant >= quantMax ) )
-    return 0;
+  if ( ( ! bp ) || ( address == EMPTY ) )
+    return -1;
 
-  for ( i = 0; i < quant; i ++ )
-    if ( address == bp[ i ] )
-      return 1;
-    else
-      /* bp is crescent order, so if current element is greater than desired
-       * address, there's no address in list
-       */
-      if (  bp[ i ] > address )
-	return 0;
+  i = slot( address );
+  if ( bp[ i ] != address )
+    return -1;
+
+  /* Move later entries of the same run back, so lookups never stop
+   * early at the hole: [ a | x | b ] => [ a | b |   ] */
+  for ( j = ( i + 1 ) & mask; bp[ j ] != EMPTY; j = ( j + 1 ) & mask )
+    {
+      home = hash( bp[ j ] );
+      if ( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) )
+	{
+	  bp[ i ] = bp[ j ];
+	  i = j;
+	}
+    }
+  bp[ i ] = EMPTY;
 
+  quant --;
+  mark_page( address );
   return 0;
 }
@@ -0,0 +1,154 @@
+/**
+ * @file      watchpoints.cpp
+ * @author    The ArchC Team
+ *            http://www.archc.org/
+ *
+ * @version   1.0
+ * @date      Mon, 19 Oct 2026
+ *
+ * @brief     Watchpoint support
+ *            This class implements watchpoint support: a small array
+ *            of watched ranges and a bitmap of the pages they cover.
+ *
+ * @attention Copyright (C) 2026 --- The ArchC Team
+ *
+ * \note When modifing this file respect:
+ * \li License
+ * \li Previous author names. Add your own after current ones.
+ * \li Coding style (basically emacs style)
+ * \li Commenting style. This code use doxygen (http://www.doxygen.org)
+ *     to be documented.
+ */
+
+#include "watchpoints.H"
+
+/**
+ * Constructor
+ *
+ * \param quant how many watchpoints to support
+ */
+Watchpoints::Watchpoints(int quant) {
+  quantMax = quant;
+  if ( ( wp = (watch *) calloc( quantMax, sizeof( watch ) ) ) == NULL )
+    {
+      perror( "Couldn't allocate watchpoint array." );
+      quantMax = 0;
+    }
+  memset( pages, 0, sizeof( pages ) );
+  this->quant = 0; /* no watchpoints at start up */
+}
+
+
+/**
+ * Destructor
+ */
+Watchpoints::~Watchpoints() {
+  if ( wp ) free( wp );
+  wp = NULL;
+}
+
+
+/**
+ * Rebuild the page bitmap from the watchpoint array.
+ */
+void Watchpoints::mark_pages() {
+  unsigned int page, last;
+  int i;
+
+  memset( pages, 0, sizeof( pages ) );
+  for ( i = 0; i < quant; i ++ )
+    {
+      last = ( wp[ i ].address + wp[ i ].length - 1 ) >> 12;
+      for ( page = wp[ i ].address >> 12; ; page ++ )
+	{
+	  pages[ page >> 3 ] |= 1 << ( page & 7 );
+	  if ( page == last )
+	    break;
+	}
+    }
+}
+
+
+/**
+ * Add watchpoint over a range
+ *
+ * \param type Watchpoints::WRITE, READ or ACCESS
+ * \param address first byte watched
+ * \param length how many bytes are watched
+ *
+ * \param 0 on success, -1 otherwise
+ */
+int Watchpoints::add(int type, unsigned int address, unsigned int length) {
+  if ( ( ! wp ) || ( quant >= quantMax ) || ( length == 0 )
+       || ( address + length - 1 < address ) )
+    return -1;
+
+  if ( ( type != WRITE ) && ( type != READ ) && ( type != ACCESS ) )
+    return -1;
+
+  wp[ quant ].type = type;
+  wp[ quant ].address = address;
+  wp[ quant ].length = length;
+  quant ++;
+  mark_pages();
+  return 0;
+}
+
+
+/**
+ * Remove watchpoint
+ *
+ * \param type Watchpoints::WRITE, READ or ACCESS
+ * \param address first byte watched
+ * \param length how many bytes are watched
+ *
+ * \param 0 on success, -1 otherwise
+ */
+int Watchpoints::remove(int type, unsigned int address, unsigned int length) {
+  int i;
+
+  if ( ! wp )
+    return -1;
+
+  for ( i = 0; i < quant; i ++ )
+    if ( ( wp[ i ].type == type ) && ( wp[ i ].address == address )
+	 && ( wp[ i ].length == length ) )
+      {
+	/* Copy remaining watchpoints: [ a | b | c ] => [ a | c ] */
+	for ( ; i < ( quant - 1 ); i ++ )
+	  wp[ i ] = wp[ i + 1 ];
+
+	quant --;
+	mark_pages();
+	return 0;
+      }
+
+  return -1;
+}
+
+
+/**
+ * Find a watchpoint hit by an access
+ *
+ * \param address first byte accessed
+ * \param size how many bytes were accessed
+ * \param write whether it was a write
+ *
+ * \return index of the watchpoint hit, -1 if none
+ */
+int Watchpoints::lookup(unsigned int address, unsigned int size, int write) {
+  int i;
+
+  for ( i = 0; i < quant; i ++ )
+    {
+      if ( wp[ i ].type == ( write ? READ : WRITE ) )
+	continue;
+
+      /* do [ address, address + size ) and the watched range overlap? */
+      if ( ( address - wp[ i ].address < wp[ i ].length )
+	   || ( wp[ i ].address - address < size ) )
+	return i;
+    }
+
+  return -1;
+}
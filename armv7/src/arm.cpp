@@ -16,6 +16,32 @@
 #include  "arm.H"
 #include  "arm_isa.cpp"
 
+//!Behavior loop hooks, which arm_isa.cpp may define.
+#ifndef AC_HOOK_LOOP_START
+#define AC_HOOK_LOOP_START()
+#endif
+#ifndef AC_HOOK_FETCH_BEGIN
+#define AC_HOOK_FETCH_BEGIN(pc)
+#endif
+#ifndef AC_HOOK_FETCH_END
+#define AC_HOOK_FETCH_END(pc)
+#endif
+#ifndef AC_HOOK_EXECUTE_BEGIN
+#define AC_HOOK_EXECUTE_BEGIN()
+#endif
+#ifndef AC_HOOK_EXECUTE_END
+#define AC_HOOK_EXECUTE_END()
+#endif
+#ifndef AC_HOOK_BATCH_END
+#define AC_HOOK_BATCH_END() wait(1, SC_NS)
+#endif
+#ifndef AC_HOOK_PRINT_STAT
+#define AC_HOOK_PRINT_STAT()
+#endif
+#ifndef AC_HOOK_GDB_STOP
+#define AC_HOOK_GDB_STOP(pc) if (gdbstub && gdbstub->stop(pc)) gdbstub->process_bp()
+#endif
+
 void arm::behavior() {
 
   unsigned ins_id;
@@ -27,6 +53,7 @@ void arm::behavior() {
 
   int action = setjmp(ac_env);
   if (action == 2) return;
+  AC_HOOK_LOOP_START();
 
   for (;;) {
 
@@ -35,7 +62,9 @@ void arm::behavior() {
     if( start_up ){
       start_up=0;
     }
+    AC_HOOK_FETCH_BEGIN(decode_pc);
     instr_dec = decode_unit->decode(decode_pc);
+    AC_HOOK_FETCH_END(decode_pc);
     ins_id = instr_dec->id;
     if( ins_id == 0 ) {
       cerr << "ArchC Error: Unidentified instruction. " << endl;
@@ -44,10 +73,11 @@ void arm::behavior() {
       return;
     }
 
-    if (gdbstub && gdbstub->stop(decode_pc)) gdbstub->process_bp();
+    AC_HOOK_GDB_STOP(decode_pc);
 
     ac_pc = decode_pc;
 
+    AC_HOOK_EXECUTE_BEGIN();
     ISA.cur_instr_id = ins_id;
     ISA._behavior_instruction(instr_dec->F_Type_DPI1.cond);
     switch (ins_id) {
@@ -512,6 +542,7 @@ void arm::behavior() {
       ISA.behavior_dsmulw(instr_dec->F_Type_DSPSM.cond, instr_dec->F_Type_DSPSM.sm, instr_dec->F_Type_DSPSM.drd, instr_dec->F_Type_DSPSM.drn, instr_dec->F_Type_DSPSM.rs, instr_dec->F_Type_DSPSM.subop2, instr_dec->F_Type_DSPSM.yy, instr_dec->F_Type_DSPSM.xx, instr_dec->F_Type_DSPSM.subop1, instr_dec->F_Type_DSPSM.rm);
       break;
     } // switch (ins_id)
+    AC_HOOK_EXECUTE_END();
     if (!ac_wait_sig) ac_instr_counter++;
 //!Updating Regs for behavioral simulation.
     if (instr_in_batch < instr_batch_size) {
@@ -519,7 +550,7 @@ void arm::behavior() {
     }
     else {
       instr_in_batch = 0;
-      wait(1, SC_NS);
+      AC_HOOK_BATCH_END();
     }
   } // for (;;)
 } // behavior()
@@ -630,6 +661,7 @@ void arm::set_ac_pc(unsigned int value) {
 // Wrapper function to PrintStat().
 void arm::PrintStat() {
   ac_arch<arm_parms::ac_word, arm_parms::ac_Hword>::PrintStat();
+  AC_HOOK_PRINT_STAT();
 }
 
 // Enables GDB
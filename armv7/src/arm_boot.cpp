@@ -0,0 +1,37 @@
+// 'arm_boot.cpp' - Core state for direct kernel boot
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "arm_core.h"
+#include "arm_interrupts.h"
+
+using namespace arm_parms;
+
+void writeCPSR(unsigned);
+extern arm_impl::processor_mode arm_proc_mode;
+
+// The Linux ARM boot protocol: supervisor mode with IRQs and FIQs
+// masked, r0 = 0, r1 = machine type and r2 = the ATAG list or device
+// tree.  The MMU and caches are still off from reset.
+void arm_core::boot_kernel(uint32_t entry, uint32_t machine, uint32_t tags) {
+  writeCPSR(arm_impl::processor_mode::SUPERVISOR_MODE | 0xC0);
+  arm_proc_mode.thumb = false;
+
+  RB.write(0, 0);
+  RB.write(1, machine);
+  RB.write(2, tags);
+  ac_pc = entry;
+}
@@ -0,0 +1,74 @@
+// 'arm_checkpoint.cpp' - Core state in checkpoints
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "arm_core.h"
+#include "arm_interrupts.h"
+
+using namespace arm_parms;
+
+unsigned readCPSR();
+void writeCPSR(unsigned);
+extern arm_impl::processor_mode arm_proc_mode;
+
+// Registers are read and written back, which is a no-op when saving.
+template <typename T>
+static void checkpoint_reg(checkpoint & c, ac_reg<T> & reg) {
+  T value = reg.read();
+  c.io(value);
+  reg.write(value);
+}
+
+// The decoder cache needs no saving: each entry is checked against
+// the fetched instruction bits before it is used.
+void arm_core::checkpoint_state(checkpoint & c) {
+  for (unsigned i = 0; i < 31; i++) {
+    ac_word value = RB.read(i);
+    c.io(value);
+    RB.write(i, value);
+  }
+  checkpoint_reg(c, ac_pc);
+
+  checkpoint_reg(c, R8_fiq);
+  checkpoint_reg(c, R9_fiq);
+  checkpoint_reg(c, R10_fiq);
+  checkpoint_reg(c, R11_fiq);
+  checkpoint_reg(c, R12_fiq);
+  checkpoint_reg(c, R13_fiq);
+  checkpoint_reg(c, R14_fiq);
+  checkpoint_reg(c, R13_irq);
+  checkpoint_reg(c, R14_irq);
+  checkpoint_reg(c, R13_svc);
+  checkpoint_reg(c, R14_svc);
+  checkpoint_reg(c, R13_abt);
+  checkpoint_reg(c, R14_abt);
+  checkpoint_reg(c, R13_und);
+  checkpoint_reg(c, R14_und);
+
+  checkpoint_reg(c, SPSR_fiq);
+  checkpoint_reg(c, SPSR_irq);
+  checkpoint_reg(c, SPSR_svc);
+  checkpoint_reg(c, SPSR_abt);
+  checkpoint_reg(c, SPSR_und);
+
+  // Flags, mode and interrupt masks.
+  uint32_t cpsr = readCPSR();
+  c.io(cpsr);
+  writeCPSR(cpsr);
+  c.io(arm_proc_mode.thumb);
+
+  c.io(ac_instr_counter);
+}
@@ -0,0 +1,58 @@
+// 'arm_core.h' - The ARM core of the platform
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ARM_CORE_H
+#define ARM_CORE_H
+
+#include "arm.H"
+#include "checkpoint.h"
+
+#include <stdint.h>
+
+// GDB stub checking data watchpoints in the model's loads and stores.
+extern AC_GDB < arm_parms::ac_word > *watch_stub;
+
+// acsim generates the core in arm.H and arm.cpp, and overwrites both
+// on each run.  What the platform adds to the core goes in this
+// subclass, which main instantiates, and in the behavior loop hooks
+// arm_isa.cpp defines.
+class arm_core:public arm, public checkpointable
+{
+public:
+
+  arm_core (sc_module_name name_):arm (name_)
+  {
+    watch_stub = gdbstub;
+  }
+
+  // AC_GDB_Interface, in arm_gdb_funcs.cpp.
+  void mem_read_block (unsigned int address, unsigned char *buffer,
+		       unsigned int size);
+  void mem_write_block (unsigned int address, const unsigned char *buffer,
+			unsigned int size);
+  unsigned long long instructions ();
+  bool reversible ();
+  bool rewind (unsigned long long target);
+
+  // Core state: registers, CPSR and the instruction count.
+  void checkpoint_state (checkpoint & c);
+
+  // Start a kernel at ENTRY, as a boot loader would leave the core.
+  void boot_kernel (uint32_t entry, uint32_t machine, uint32_t tags);
+};
+
+#endif // !ARM_CORE_H.
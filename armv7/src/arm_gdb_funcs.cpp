@@ -18,7 +18,8 @@
  *
  */
 
-#include "arm.H"
+#include "arm_core.h"
+#include "history.h"
 
 using namespace arm_parms;
 
@@ -27,6 +28,8 @@ void writeCPSR(unsigned);
 unsigned bypass_read(unsigned address);
 void bypass_write(unsigned address, unsigned datum);
 
+extern history *hist;
+
 int arm::nRegs(void) {
    return 17;
 }
@@ -72,3 +75,60 @@ void arm::mem_write( unsigned int address, unsigned char byte ) {
   MEM.write_byte( address, byte );
 }
 
+
+// Blocks go by word, so a GDB memory packet costs one bus transaction
+// per word instead of one per byte.  Only the unaligned head and tail
+// are accessed by byte.
+void arm_core::mem_read_block( unsigned int address, unsigned char *buffer,
+                               unsigned int size ) {
+  while ( size && ( address % 4 ) ) {
+    *buffer++ = mem_read( address++ );
+    size--;
+  }
+
+  for ( ; size >= 4; size -= 4, address += 4, buffer += 4 ) {
+    unsigned word = MEM.read( address );
+
+    buffer[0] = word;
+    buffer[1] = word >> 8;
+    buffer[2] = word >> 16;
+    buffer[3] = word >> 24;
+  }
+
+  while ( size-- )
+    *buffer++ = mem_read( address++ );
+}
+
+void arm_core::mem_write_block( unsigned int address,
+                                const unsigned char *buffer,
+                                unsigned int size ) {
+  while ( size && ( address % 4 ) ) {
+    mem_write( address++, *buffer++ );
+    size--;
+  }
+
+  for ( ; size >= 4; size -= 4, address += 4, buffer += 4 )
+    MEM.write( address, buffer[0] | ( buffer[1] << 8 ) | ( buffer[2] << 16 )
+               | ( (unsigned) buffer[3] << 24 ) );
+
+  while ( size-- )
+    mem_write( address++, *buffer++ );
+}
+
+unsigned long long arm_core::instructions() {
+  return ac_instr_counter;
+}
+
+bool arm_core::reversible() {
+  return hist != NULL;
+}
+
+bool arm_core::rewind(unsigned long long target) {
+  if (hist == NULL || !hist->rewind(target))
+    return false;
+
+  // Snapshots are taken between batches, so the batch starts over too.
+  // The behavior loop refetches at the restored PC.
+  instr_in_batch = 0;
+  return true;
+}
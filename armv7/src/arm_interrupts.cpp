@@ -2,6 +2,11 @@
 #include "arm_arch_ref.H"
 #include <cassert>
 #include <cp15.h>
+#include "counters.h"
+#include "trace.h"
+#include "pmu.h"
+#include "latency.h"
+#include "profiler.h"
 
 // Exception vector addresses
 static const unsigned int RESET_ADDR             = 0x00000000;
@@ -13,6 +18,11 @@ static const unsigned int IRQ_ADDR               = 0x00000018;
 static const unsigned int FIQ_ADDR               = 0x0000001c;
 
 extern coprocessor *CP[16];
+extern sim_counters *counters;
+extern trace_recorder *tracer;
+extern pmu *perfmon;
+extern irq_latency *irq_stats;
+extern pc_profiler *profiler;
 
 unsigned readCPSR();
 void writeCPSR(unsigned);
@@ -29,6 +39,11 @@ void service_interrupt(arm_arch_ref& ref, unsigned excep_type) {
   if ((cpsr & (1 << 7)) && excep_type == arm_impl::EXCEPTION_IRQ)
     return;
 
+  counters->exception(excep_type);
+  perfmon->count(pmu::EXCEPTION);
+  if (irq_stats && excep_type == arm_impl::EXCEPTION_IRQ)
+    irq_stats->enter(cpsr);
+
 #ifdef HIGH_VECTOR
   interrupt_vector_base = 0xffff0000;
 #else
@@ -37,6 +52,9 @@ void service_interrupt(arm_arch_ref& ref, unsigned excep_type) {
     getRegisterValue(cp15::SECURE_OR_NONSECURE_VECTOR_BASE_ADDRESS) & ~(0x1f);
 #endif
 
+  if (tracer)
+    tracer->exception(excep_type, ref.ac_pc, interrupt_vector_base, cpsr);
+
   switch(excep_type) {
   case arm_impl::EXCEPTION_RESET:
     ref.R14_svc = 0;
@@ -109,6 +127,9 @@ void service_interrupt(arm_arch_ref& ref, unsigned excep_type) {
     abort();
     break;
   }
+  if (profiler)
+    profiler->exception(ref.ac_pc);
+
   cpsr = cpsr & ~(1 << 5); // execute in ARM state
   cpsr = cpsr | (1 << 7); // disable normal interrupts
 
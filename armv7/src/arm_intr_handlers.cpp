@@ -3,10 +3,15 @@
 #include "ac_intr_handler.H"
 #include "arm_intr_handlers.H"
 #include "arm_ih_bhv_macros.H"
+#include "idle.h"
+#include "quantum.h"
 
 //!'using namespace' statement to allow access to all arm-specific datatypes
 using namespace arm_parms;
 
+extern idle_detector *idle_det;
+extern quantum_keeper *qkeeper;
+
 // Whoever calls this interrupt, it must enforce correct exception priority,
 // since we can't enforce this here. We simply service the first one to call
 // this method. The correct exception priority is:
@@ -20,6 +25,16 @@ using namespace arm_parms;
 
 // Interrupt handler behavior for interrupt port inta.
 void ac_behavior(inta, value) {
+  // The core may be waiting for a device access to complete.  IRQ and
+  // FIQ lines stay asserted, so they will be signaled again at the next
+  // synchronization, between instructions.
+  if ((value == arm_impl::EXCEPTION_IRQ || value == arm_impl::EXCEPTION_FIQ)
+      && qkeeper->in_instruction())
+    return;
+
+  // Wake up an idle core even if the exception is masked, as WFI does.
+  if (idle_det)
+    idle_det->interrupt();
   service_interrupt(*this, value);  
 }
 
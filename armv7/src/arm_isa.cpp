@@ -28,6 +28,20 @@
 #include <stdint.h> // define types uint32_t, etc
 #include "coprocessor.h"
 #include "mmu.h"
+#include "idle.h"
+#include "quantum.h"
+#include "profiler.h"
+#include "counters.h"
+#include "host_profile.h"
+#include "trace.h"
+#include "cache.h"
+#include "pmu.h"
+#include "throughput.h"
+#include "coverage.h"
+#include "latency.h"
+#include "checkpoint.h"
+#include "history.h"
+#include "sampling.h"
 
 using namespace arm_parms;
 
@@ -35,6 +49,19 @@ extern bool DEBUG_FLOW;
 extern bool DEBUG_CORE;
 extern coprocessor * CP[16];
 extern MMU *mmu;
+extern idle_detector *idle_det;
+extern quantum_keeper *qkeeper;
+extern pc_profiler *profiler;
+extern sim_counters *counters;
+extern trace_recorder *tracer;
+extern memory_hierarchy *caches;
+extern pmu *perfmon;
+extern throughput_meter *meter;
+extern coverage_map *coverage;
+extern irq_latency *irq_stats;
+extern checkpoint *ckpt;
+extern history *hist;
+extern sampler *sampling;
 
 #include "defines.H"
 
@@ -100,13 +127,88 @@ static reg_t OP2;
 // #ifdef SYSTEM_MODEL
 #define RB_write       bypass_write
 #define RB_read        bypass_read
-#define MEM_read       MEM.read
-#define MEM_read_byte  MEM.read_byte
-#define MEM_write      MEM.write
-#define MEM_write_half MEM.write_half
-#define MEM_write_byte MEM.write_byte
+#define MEM_read(a)    trace_load((a), MEM.read(a), 4)
+#define MEM_read_byte(a) trace_load((a), MEM.read_byte(a), 1)
+#define MEM_write(a, d) (trace_store((a), (d), 4), MEM.write((a), (d)))
+#define MEM_write_half(a, d) (trace_store((a), (d), 2), MEM.write_half((a), (d)))
+#define MEM_write_byte(a, d) (trace_store((a), (d), 1), MEM.write_byte((a), (d)))
 //#endif
 
+// GDB stub checking data watchpoints, set by arm_core.  It ignores
+// accesses while GDB support is disabled.
+AC_GDB<ac_word> *watch_stub = 0;
+
+// Data accesses are counted by the PMU, recorded in the execution
+// trace, if any, and checked against GDB watchpoints.
+static inline uint32_t trace_load(uint32_t addr, uint32_t value, unsigned size) {
+    perfmon->count(pmu::LOAD);
+    if(tracer)
+        tracer->load(addr, value, size);
+    if(watch_stub)
+        watch_stub->watch(addr, size, false);
+    return value;
+}
+
+static inline void trace_store(uint32_t addr, uint32_t value, unsigned size) {
+    perfmon->count(pmu::STORE);
+    if(tracer)
+        tracer->store(addr, value, size);
+    if(watch_stub)
+        watch_stub->watch(addr, size, true);
+}
+
+// Hooks into the behavior loop acsim generates in arm.cpp.
+// Instruction fetches are told apart from data accesses by the caches
+// and the PMU, and the decoded address is recorded for coverage.
+static inline void fetch_begin(uint32_t pc) {
+    HOST_PROFILE_BEGIN(HP_DECODE);
+    if(caches)
+        caches->begin_fetch(pc);
+    perfmon->fetching = true;
+}
+
+static inline void fetch_end(uint32_t pc) {
+    perfmon->fetching = false;
+    if(caches)
+        caches->end_fetch();
+    if(coverage)
+        coverage->hit(pc);
+    HOST_PROFILE_END();
+}
+
+// Each batch takes one platform cycle of core local time.  The core
+// only yields to the platform when its quantum is used up.
+static void end_batch(unsigned long long instructions, uint32_t pc,
+                      AC_GDB<ac_word> *stub) {
+    qkeeper->inc(1);
+    if (qkeeper->need_sync()) {
+        qkeeper->sync();
+        // Snapshots for GDB reverse execution, with the platform in step.
+        if(hist)
+            hist->poll(instructions);
+    }
+    counters->poll();
+    perfmon->poll();
+    meter->poll(instructions, pc);
+    ckpt->poll(instructions);
+    if(sampling)
+        sampling->poll(instructions);
+    // GDB Control-C and SIGUSR2 take effect here.  GDB support may
+    // have been turned on by the latter.
+    stub->poll();
+}
+
+#define AC_HOOK_LOOP_START() HOST_PROFILE_UNWIND()
+#define AC_HOOK_FETCH_BEGIN(pc) fetch_begin(pc)
+#define AC_HOOK_FETCH_END(pc) fetch_end(pc)
+#define AC_HOOK_EXECUTE_BEGIN() HOST_PROFILE_BEGIN(HP_DISPATCH)
+#define AC_HOOK_EXECUTE_END() HOST_PROFILE_END()
+#define AC_HOOK_BATCH_END() end_batch(ac_instr_counter, ac_pc, gdbstub)
+#define AC_HOOK_PRINT_STAT() meter->print_stats(stderr, ac_instr_counter)
+
+// A rewound core starts over with the fetch at its restored PC.
+#define AC_HOOK_GDB_STOP(pc) if (gdbstub && gdbstub->stop(pc) && gdbstub->process_bp()) continue
+
 // If SYSTEM_MODEL, These methods take control whenever
 // a instruciton attempts to write/read the main
 // Register Bank.
@@ -338,9 +440,16 @@ void writeCPSR(unsigned value) {
     arm_proc_mode.mode = value & arm_impl::processor_mode::MODE_MASK;
 }
 
+unsigned readSPSR();
+
 // This function implements the transfer of the SPSR of the current processor
 // mode to the CPSR, usually executed when exiting from an exception handler.
 static void SPSRtoCPSR() {
+    if(irq_stats)
+        irq_stats->restore(readSPSR());
+    if(profiler)
+        profiler->exception_return();
+
     switch (arm_proc_mode.mode) {
     case arm_impl::processor_mode::FIQ_MODE:
         writeCPSR(ref->SPSR_fiq);
@@ -416,6 +525,13 @@ void ac_behavior( instruction ) {
 
     dprintf("-------------------- PC=%#x -------------------- %lld\n", (uint32_t)ac_pc, ac_instr_counter);
 
+    counters->instruction(cur_instr_id, arm_proc_mode.mode);
+    perfmon->count(pmu::INSTRUCTION);
+    if(tracer)
+        tracer->instruction(ac_pc, cur_instr_id, arm_proc_mode.mode, readCPSR());
+    if(profiler)
+        profiler->step(ac_pc, arm_proc_mode.mode);
+
     // Conditionally executes instruction based on COND field, common to all ARM instructions.
     execute = false;
 
@@ -1309,6 +1425,7 @@ inline void B(int h, int offset,
               ac_reg<unsigned>& ac_pc) {
 
     uint32_t mem_pos, s_extend;
+    uint32_t branch_pc = RB_read(PC) - 4;
 
     // Note that PC is already incremented by 4, i.e., pointing to the next instruction
 
@@ -1326,10 +1443,24 @@ inline void B(int h, int offset,
         return;
     } else RB_write(PC, mem_pos);
 
-    if(h == 1) // BL
+    if(h == 1) { // BL
         dprintbt_enter(mem_pos, RB_read(LR));
+        if(profiler)
+            profiler->call(mem_pos, RB_read(LR));
+    }
 
     ac_pc = RB_read(PC);
+    perfmon->count(pmu::BRANCH_IMMEDIATE);
+    perfmon->count(pmu::PC_WRITE);
+
+    // Short backward branches may close an idle loop.
+    if(h == 0 && idle_det && idle_det->loop_candidate(branch_pc, mem_pos)) {
+        uint32_t state[idle_detector::STATE_SIZE];
+        for(int i = 0; i < 15; i++)
+            state[i] = RB_read(i);
+        state[15] = readCPSR();
+        idle_det->branch(branch_pc, mem_pos, state);
+    }
 }
 
 //------------------------------------------------------
@@ -1347,6 +1478,7 @@ inline void BX(int rm,
 
     flags.T = isBitSet(rm, 0);
     ac_pc = RB_read(rm) & 0xFFFFFFFE;
+    perfmon->count(pmu::PC_WRITE);
 
     //dprintf("Pc = 0x%X",ac_pc);
 }
@@ -3104,6 +3236,10 @@ void ac_behavior( blx2 ){
     flags.T = isBitSet(rm, 0);
     RB_write(PC, dest.entire & 0xFFFFFFFE);
     ac_pc = RB_read(PC);
+    perfmon->count(pmu::PC_WRITE);
+
+    if(profiler)
+        profiler->call(RB_read(PC), RB_read(LR));
 
     dprintf("Calculated branch destination: 0x%lX\n", RB_read(PC));
 }
@@ -3321,6 +3457,16 @@ void ac_behavior( msr2 ){
     temp.entire = imm8;
     unsigned in = RotateRight(rotate*2, temp).entire;
     unsigned res;
+
+    // MSR with an empty mask encodes the hint instructions (NOP, YIELD,
+    // WFE, WFI and SEV).  Only WFI and WFE are of any interest to us.
+    if (r == 0 && fieldmask == 0) {
+        dprintf("Instruction: Hint #%d\n", imm8);
+        if ((imm8 == 2 || imm8 == 3) && idle_det)
+            idle_det->wfi();
+        return;
+    }
+
     dprintf("Instruction: MSR\n");
     // Write to CPSR
     if (r == 0)  {
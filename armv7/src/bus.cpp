@@ -24,8 +24,17 @@
 
 #include "bus.h"
 #include "defines.H"
+#include "idle.h"
+#include "quantum.h"
+#include "counters.h"
+#include "mmio_profile.h"
+#include "host_profile.h"
 
 extern bool DEBUG_BUS;
+extern idle_detector *idle_det;
+extern quantum_keeper *qkeeper;
+extern sim_counters *counters;
+extern mmio_profile *mmio_stats;
 #define dprintf(args...)                        \
   if(DEBUG_BUS)                                 \
     fprintf(stderr,args);
@@ -34,11 +43,26 @@ extern bool DEBUG_BUS;
 void
 imx53_bus::connect_device (peripheral * device,
 			   const uint32_t start_address,
-			   const uint32_t end_address)
+			   const uint32_t end_address, bool timed)
 {
   devices[n_of_devices].device = device;
   devices[n_of_devices].start_address = start_address;
   devices[n_of_devices].end_address = end_address;
+  devices[n_of_devices].timed = timed;
+
+  sc_object *obj = dynamic_cast < sc_object * >(device);
+
+  // Memories are not registers, leave them out.
+  devices[n_of_devices].counter = -1;
+  if (timed)
+    devices[n_of_devices].counter =
+      counters->add_device (obj ? obj->name () : "unknown");
+
+  devices[n_of_devices].profile = -1;
+  if (mmio_stats && timed)
+    devices[n_of_devices].profile =
+      mmio_stats->add_device (obj ? obj->name () : "unknown", start_address,
+			      end_address);
   n_of_devices++;
 }
 
@@ -47,6 +71,7 @@ imx53_bus::connect_device (peripheral * device,
 ac_tlm_rsp
 imx53_bus::transport (const ac_tlm_req & req)
 {
+  HOST_PROFILE_SCOPE (HP_BUS);
   ac_tlm_rsp ans;
   unsigned addr = req.addr;
   unsigned offset = (addr % 4) * 8;
@@ -69,9 +94,19 @@ imx53_bus::transport (const ac_tlm_req & req)
       struct imx53_bus::mapped_device *cur = &(devices[i]);
       if (addr >= cur->start_address && addr <= cur->end_address)
 	{
+	  // Bring the platform up to the core time before talking to a
+	  // device that may have changed meanwhile.
+	  if (cur->timed)
+	    qkeeper->sync (true);
+
 	  if (req.type == READ)
 	    {
 	      dprintf (" <--> BUS TRANSACTION: [READ] 0x%X\n", addr);
+	      if (cur->counter >= 0)
+		counters->mmio_read (cur->counter);
+	      if (cur->profile >= 0)
+		mmio_stats->access (cur->profile, addr - cur->start_address,
+				    false);
 
 	      ans.data =
 		devices[i].device->read_signal ((addr - devices[i].start_address),
@@ -81,15 +116,24 @@ imx53_bus::transport (const ac_tlm_req & req)
               if (offset)
                 ans.data = ans.data >> offset;
 #endif
+              if (idle_det && idle_det->enabled)
+                idle_det->bus_read (addr, ans.data);
               return ans;
 	    }
 	  else if (req.type == WRITE)
 	    {
 	      dprintf (" <--> BUS TRANSACTION: [WRITE] 0x%X @0x%X \n",
 		       req.data, addr);
+	      if (cur->counter >= 0)
+		counters->mmio_write (cur->counter);
+	      if (cur->profile >= 0)
+		mmio_stats->access (cur->profile, addr - cur->start_address,
+				    true);
 
 	      devices[i].device->write_signal ((addr - devices[i].start_address),
                                                req.data, offset);
+              if (idle_det && idle_det->enabled)
+                idle_det->bus_write ();
 	      return ans;
 	    }
 	}
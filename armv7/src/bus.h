@@ -58,6 +58,16 @@ class imx53_bus:public sc_module, public ac_tlm_transport_if
 
     // End of device's address space.
     uint32_t end_address;
+
+    // Whether the device must see the core time on each access.
+    // Memories never change on their own, so they don't.
+    bool timed;
+
+    // Index in the MMIO counters, or -1 if not counted.
+    int counter;
+
+    // Index in the MMIO register profile, or -1 if not profiled.
+    int profile;
   };
 
   // Data structure to hold every device attached to bus.
@@ -76,7 +86,7 @@ class imx53_bus:public sc_module, public ac_tlm_transport_if
   };
 
   void connect_device (peripheral * device, const uint32_t start_address,
-		       const uint32_t end_address);
+		       const uint32_t end_address, bool timed = true);
 
   ac_tlm_rsp transport (const ac_tlm_req & req);
 };
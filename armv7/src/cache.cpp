@@ -0,0 +1,311 @@
+// 'cache.cpp' - Memory hierarchy model
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cache.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+
+// Regions listed in the report.
+static const size_t TOP_REGIONS = 20;
+
+static unsigned
+log2u (unsigned x)
+{
+  unsigned n = 0;
+
+  while (x >>= 1)
+    n++;
+  return n;
+}
+
+cache_level::cache_level (const char *name, const config & cfg,
+			  cache_level * next):
+reads (0), read_misses (0), writes (0), write_misses (0), writebacks (0),
+name (name), cfg (cfg), next (next), clock (0)
+{
+  n_sets = cfg.size / (cfg.block_size * cfg.ways);
+  block_shift = log2u (cfg.block_size);
+  lines.resize (n_sets * cfg.ways);
+}
+
+cache_level::line *
+cache_level::lookup (uint32_t addr)
+{
+  uint32_t block = addr >> block_shift;
+  line *set = &lines[(block % n_sets) * cfg.ways];
+
+  for (unsigned i = 0; i < cfg.ways; i++)
+    if (set[i].valid && set[i].tag == block)
+      {
+	set[i].last_use = ++clock;
+	return &set[i];
+      }
+  return NULL;
+}
+
+// Bring the block holding ADDR in, evicting another one if needed.
+cache_level::line *
+cache_level::fill (uint32_t addr)
+{
+  uint32_t block = addr >> block_shift;
+  line *set = &lines[(block % n_sets) * cfg.ways];
+  line *victim = NULL;
+
+  for (unsigned i = 0; i < cfg.ways && victim == NULL; i++)
+    if (!set[i].valid)
+      victim = &set[i];
+
+  if (victim == NULL)
+    {
+      if (cfg.policy == REPLACE_RANDOM)
+	victim = &set[rand () % cfg.ways];
+      else
+	{
+	  victim = &set[0];
+	  for (unsigned i = 1; i < cfg.ways; i++)
+	    if (set[i].last_use < victim->last_use)
+	      victim = &set[i];
+	}
+
+      if (victim->dirty)
+	{
+	  writebacks++;
+	  if (next)
+	    next->write (victim->tag << block_shift);
+	}
+    }
+
+  if (next)
+    next->read (block << block_shift);
+
+  victim->tag = block;
+  victim->valid = true;
+  victim->dirty = false;
+  victim->last_use = ++clock;
+  return victim;
+}
+
+bool
+cache_level::read (uint32_t addr)
+{
+  reads++;
+  if (lookup (addr))
+    return true;
+
+  read_misses++;
+  fill (addr);
+  return false;
+}
+
+bool
+cache_level::write (uint32_t addr)
+{
+  line *l = lookup (addr);
+  bool hit = l != NULL;
+
+  writes++;
+  if (!hit)
+    {
+      write_misses++;
+      if (cfg.write_allocate)
+	l = fill (addr);
+    }
+
+  if (l && cfg.write_back)
+    l->dirty = true;
+  else if (next)
+    next->write (addr);
+
+  return hit;
+}
+
+static double
+percent (uint64_t part, uint64_t total)
+{
+  return total ? 100.0 * part / total : 0.0;
+}
+
+void
+cache_level::print_stats (FILE * stream) const
+{
+  fprintf (stream, "ArchC: %-4s %uKiB %u-way %uB: "
+	   "%llu reads (%.2f%% miss), %llu writes (%.2f%% miss), "
+	   "%llu write-backs\n", name, cfg.size / 1024, cfg.ways,
+	   cfg.block_size, (unsigned long long) reads,
+	   percent (read_misses, reads), (unsigned long long) writes,
+	   percent (write_misses, writes), (unsigned long long) writebacks);
+}
+
+void
+cache_level::reset_stats ()
+{
+  reads = read_misses = 0;
+  writes = write_misses = 0;
+  writebacks = 0;
+}
+
+memory_hierarchy::memory_hierarchy (const cache_level::config & l1,
+				    const cache_level::config & l2_cfg,
+				    unsigned region_size):
+l2 (NULL), fetching (false), cur_pc (0), last_key (~0U), last_region (NULL)
+{
+  if (l2_cfg.size)
+    l2 = new cache_level ("L2", l2_cfg, NULL);
+  l1i = new cache_level ("L1I", l1, l2);
+  l1d = new cache_level ("L1D", l1, l2);
+  region_shift = log2u (region_size);
+}
+
+memory_hierarchy::~memory_hierarchy ()
+{
+  delete l1i;
+  delete l1d;
+  delete l2;
+}
+
+void
+memory_hierarchy::add_cacheable (uint32_t start, uint32_t end)
+{
+  range r;
+
+  r.start = start;
+  r.end = end;
+  cacheable.push_back (r);
+}
+
+void
+memory_hierarchy::reset_stats ()
+{
+  l1i->reset_stats ();
+  l1d->reset_stats ();
+  if (l2)
+    l2->reset_stats ();
+  regions.clear ();
+  last_region = NULL;
+}
+
+bool
+memory_hierarchy::is_cacheable (uint32_t addr) const
+{
+  for (size_t i = 0; i < cacheable.size (); i++)
+    if (addr >= cacheable[i].start && addr <= cacheable[i].end)
+      return true;
+  return false;
+}
+
+void
+memory_hierarchy::access (uint32_t addr, bool write)
+{
+  uint64_t l2_misses = l2 ? l2->read_misses + l2->write_misses : 0;
+  uint32_t key = cur_pc >> region_shift;
+  bool hit;
+
+  if (!is_cacheable (addr))
+    return;
+
+  if (fetching)
+    hit = l1i->read (addr);
+  else if (write)
+    hit = l1d->write (addr);
+  else
+    hit = l1d->read (addr);
+
+  if (key != last_key || last_region == NULL)
+    {
+      last_key = key;
+      last_region = &regions[key];
+    }
+
+  if (fetching)
+    {
+      last_region->fetches++;
+      last_region->fetch_misses += !hit;
+    }
+  else
+    {
+      last_region->data++;
+      last_region->data_misses += !hit;
+    }
+  if (l2)
+    last_region->l2_misses += l2->read_misses + l2->write_misses - l2_misses;
+}
+
+static bool
+by_misses (const std::pair < std::string, std::vector < uint64_t > >&a,
+	   const std::pair < std::string, std::vector < uint64_t > >&b)
+{
+  return a.second[1] + a.second[3] > b.second[1] + b.second[3];
+}
+
+void
+memory_hierarchy::print_stats (FILE * stream, symbol_table & symbols)
+{
+  typedef std::map < std::string, std::vector < uint64_t > > table;
+  std::vector < std::pair < std::string, std::vector < uint64_t > > > sorted;
+  table named;
+
+  l1i->print_stats (stream);
+  l1d->print_stats (stream);
+  if (l2)
+    l2->print_stats (stream);
+
+  // Regions are attributed to the symbol holding their first byte, if
+  // symbols are known.
+  for (std::map < uint32_t, region >::iterator it = regions.begin ();
+       it != regions.end (); ++it)
+    {
+      uint32_t base = it->first << region_shift;
+      std::string name;
+      char buf[32];
+
+      if (!symbols.empty ())
+	name = symbols.name (base);
+      else
+	{
+	  snprintf (buf, sizeof (buf), "0x%08x-0x%08x", base,
+		    base + (1U << region_shift) - 1);
+	  name = buf;
+	}
+
+      std::vector < uint64_t > &counts = named[name];
+      counts.resize (5);
+      counts[0] += it->second.fetches;
+      counts[1] += it->second.fetch_misses;
+      counts[2] += it->second.data;
+      counts[3] += it->second.data_misses;
+      counts[4] += it->second.l2_misses;
+    }
+
+  sorted.assign (named.begin (), named.end ());
+  std::stable_sort (sorted.begin (), sorted.end (), by_misses);
+  if (sorted.size () > TOP_REGIONS)
+    sorted.resize (TOP_REGIONS);
+
+  fprintf (stream, "ArchC: %-32s %12s %8s %12s %8s %10s\n", "code region",
+	   "fetches", "L1I miss", "data", "L1D miss", "L2 misses");
+  for (size_t i = 0; i < sorted.size (); i++)
+    {
+      std::vector < uint64_t > &c = sorted[i].second;
+
+      fprintf (stream, "ArchC: %-32s %12llu %7.2f%% %12llu %7.2f%% %10llu\n",
+	       sorted[i].first.c_str (), (unsigned long long) c[0],
+	       percent (c[1], c[0]), (unsigned long long) c[2],
+	       percent (c[3], c[2]), (unsigned long long) c[4]);
+    }
+}
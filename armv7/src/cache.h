@@ -0,0 +1,179 @@
+// 'cache.h' - Memory hierarchy model
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "symtab.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+// Set-associative cache with the parameters of ArchC's ac_cache: block
+// size, number of blocks, set size, LRU or random replacement and
+// write-back/write-through, write-allocate/write-around policies.
+// Unlike ac_cache, it keeps tags only.  Data always comes from the
+// bus, so the model can't change what the guest computes; it only
+// counts what a real hierarchy would do.
+class cache_level
+{
+public:
+
+  enum replacement
+  {
+    REPLACE_LRU,
+    REPLACE_RANDOM
+  };
+
+  struct config
+  {
+    unsigned size;		// Bytes.
+    unsigned ways;
+    unsigned block_size;	// Bytes.
+    replacement policy;
+    bool write_back;
+    bool write_allocate;
+  };
+
+  cache_level (const char *name, const config & cfg, cache_level * next);
+
+  // Both return true on a hit.
+  bool read (uint32_t addr);
+  bool write (uint32_t addr);
+
+  void print_stats (FILE * stream) const;
+
+  // Start counting again.  The contents stay, warm.
+  void reset_stats ();
+
+  uint64_t reads, read_misses;
+  uint64_t writes, write_misses;
+  uint64_t writebacks;
+
+private:
+
+  struct line
+  {
+    uint32_t tag;
+    bool valid;
+    bool dirty;
+    uint64_t last_use;
+  };
+
+  const char *name;
+  config cfg;
+  cache_level *next;
+
+  unsigned n_sets;
+  unsigned block_shift;
+  std::vector < line > lines;
+  uint64_t clock;
+
+  line *lookup (uint32_t addr);
+  line *fill (uint32_t addr);
+};
+
+// Separate L1 instruction and data caches over an optional unified L2,
+// like the Cortex-A8 CLIDR reported by cp15 describes.  The MMU feeds
+// it physical addresses after translation.  Accesses are also counted
+// per code region, that is, by the PC of the instruction making them.
+class memory_hierarchy
+{
+public:
+
+  memory_hierarchy (const cache_level::config & l1,
+		    const cache_level::config & l2, unsigned region_size);
+  ~memory_hierarchy ();
+
+  // Only memories are cached, never devices.
+  void add_cacheable (uint32_t start, uint32_t end);
+
+  // The core is fetching the instruction at PC.  Later data accesses
+  // belong to it too.
+  void begin_fetch (uint32_t pc)
+  {
+    fetching = true;
+    cur_pc = pc;
+  }
+
+  void end_fetch ()
+  {
+    fetching = false;
+  }
+
+  void access (uint32_t addr, bool write);
+
+  void print_stats (FILE * stream, symbol_table & symbols);
+
+  const cache_level & instruction_l1 () const
+  {
+    return *l1i;
+  }
+
+  const cache_level & data_l1 () const
+  {
+    return *l1d;
+  }
+
+  enum
+  {
+    L1I, L1D, L2, LEVELS
+  };
+
+  // Level I, or NULL if there is no L2.
+  cache_level *level (unsigned i)
+  {
+    return i == L1I ? l1i : i == L1D ? l1d : l2;
+  }
+
+  void reset_stats ();
+
+private:
+
+  struct range
+  {
+    uint32_t start;
+    uint32_t end;
+  };
+
+  struct region
+  {
+    uint64_t fetches, fetch_misses;
+    uint64_t data, data_misses;
+    uint64_t l2_misses;
+  };
+
+  cache_level *l1i;
+  cache_level *l1d;
+  cache_level *l2;
+
+  std::vector < range > cacheable;
+
+  bool fetching;
+  uint32_t cur_pc;
+
+  unsigned region_shift;
+  std::map < uint32_t, region > regions;
+  uint32_t last_key;
+  region *last_region;
+
+  bool is_cacheable (uint32_t addr) const;
+};
+
+#endif // !CACHE_H.
@@ -28,12 +28,13 @@
 #include <ac_tlm_protocol.H>
 #include "peripheral.h"
 #include "tzic.h"
+#include "checkpoint.h"
 
 // This is a dumb CCM reacting as described by iMX53 QSB iMXRM manual.
 // It does not actually performs any action, since our model is not clock accurated.
 // We just respond to Core as if the command was executed.
 
-class ccm_module:public sc_module, public peripheral
+class ccm_module:public sc_module, public peripheral, public checkpointable
 {
 private:
   tzic_module & tzic;
@@ -81,6 +82,10 @@ public:
     fast_write (address, datum, offset);
   }
 
+  void checkpoint_state (checkpoint & c)
+  {
+    c.io (regs);
+  }
 };
 
 #endif // !CCM_H
@@ -0,0 +1,445 @@
+// 'checkpoint.cpp' - Platform checkpoints
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "checkpoint.h"
+#include "quantum.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+extern quantum_keeper *qkeeper;
+
+// Output buffer.  Memories are written a page at a time.
+static const size_t OUT_BUFFER_SIZE = 1 << 20;
+
+static double
+host_time ()
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// FILE, without the directories.
+static const char *
+base_name (const char *file)
+{
+  const char *slash = strrchr (file, '/');
+
+  return slash ? slash + 1 : file;
+}
+
+// Read the header of FILE.  Returns 0 on success and -1 on failure.
+static int
+read_header (const char *file, struct checkpoint_header *header)
+{
+  FILE *f = fopen (file, "rb");
+
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  if (fread (header, sizeof (*header), 1, f) != 1
+      || memcmp (header->magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) != 0)
+    {
+      fprintf (stderr, "ArchC: %s is not a checkpoint file\n", file);
+      fclose (f);
+      return -1;
+    }
+
+  fclose (f);
+  header->parent[CHECKPOINT_PARENT_SIZE - 1] = '\0';
+  return 0;
+}
+
+checkpoint::checkpoint ():
+out (NULL), cursor (NULL), end (NULL), failed (false), incremental (false),
+states_only (false), base (NULL), interval (0), batches (0), sequence (0),
+last_time (0), parent_instructions (0)
+{
+}
+
+void
+checkpoint::add (const char *name, checkpointable * state, uint32_t type)
+{
+  device d;
+
+  d.name = name;
+  d.state = state;
+  d.type = type;
+  devices.push_back (d);
+}
+
+void
+checkpoint::io_bytes (void *data, size_t size)
+{
+  if (out != NULL)
+    {
+      if (fwrite (data, size, 1, out) != 1)
+	failed = true;
+      return;
+    }
+
+  if ((size_t) (end - cursor) < size)
+    {
+      failed = true;
+      memset (data, 0, size);
+      cursor = end;
+      return;
+    }
+  memcpy (data, cursor, size);
+  cursor += size;
+}
+
+void
+checkpoint::save_page (uint32_t offset, const void *data)
+{
+  io (offset);
+  io_bytes (const_cast < void *>(data), CHECKPOINT_PAGE_SIZE);
+}
+
+bool
+checkpoint::restore_page (uint32_t * offset, const void **data)
+{
+  if (cursor == end)
+    return false;
+
+  io (*offset);
+  if ((size_t) (end - cursor) < CHECKPOINT_PAGE_SIZE)
+    {
+      failed = true;
+      cursor = end;
+      return false;
+    }
+  *data = cursor;
+  cursor += CHECKPOINT_PAGE_SIZE;
+  return true;
+}
+
+void
+checkpoint::set_periodic (const char *base_, unsigned seconds)
+{
+  base = base_;
+  interval = seconds;
+  last_time = host_time ();
+}
+
+void
+checkpoint::check (uint64_t instructions)
+{
+  double now = host_time ();
+  char file[4096];
+
+  if (now - last_time < interval)
+    return;
+  last_time = now;
+
+  snprintf (file, sizeof (file), "%s.%u", base, ++sequence);
+  if (write (file, instructions,
+	     (uint64_t) (qkeeper->get_current_time ().to_seconds () * 1e9),
+	     !parent.empty ()) != 0)
+    {
+      // The next one can't go on top of this one.
+      parent.clear ();
+      return;
+    }
+  parent = file;
+  parent_instructions = instructions;
+}
+
+int
+checkpoint::save (const char *file, uint64_t instructions, uint64_t time_ns)
+{
+  return write (file, instructions, time_ns, false);
+}
+
+int
+checkpoint::write (const char *file, uint64_t instructions,
+		   uint64_t time_ns, bool delta)
+{
+  std::string tmp = std::string (file) + ".tmp";
+  FILE *f;
+
+  f = fopen (tmp.c_str (), "wb");
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write checkpoint to %s: %s\n",
+	       tmp.c_str (), strerror (errno));
+      return -1;
+    }
+  setvbuf (f, NULL, _IOFBF, OUT_BUFFER_SIZE);
+
+  if (write_sections (f, instructions, time_ns, delta) != 0)
+    {
+      fclose (f);
+      fprintf (stderr, "ArchC: Unable to write checkpoint to %s: %s\n",
+	       file, strerror (errno));
+      return -1;
+    }
+
+  if (fclose (f) != 0 || rename (tmp.c_str (), file) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to write checkpoint to %s: %s\n",
+	       file, strerror (errno));
+      return -1;
+    }
+
+  fprintf (stderr, "ArchC: %s saved to %s after %llu instructions\n",
+	   delta ? "Delta checkpoint" : "Checkpoint", file,
+	   (unsigned long long) instructions);
+  return 0;
+}
+
+int
+checkpoint::save_state (FILE * stream, uint64_t instructions,
+			uint64_t time_ns)
+{
+  int ret;
+
+  states_only = true;
+  ret = write_sections (stream, instructions, time_ns, false);
+  states_only = false;
+  return ret;
+}
+
+// Whether device I goes in the checkpoint being saved or restored.
+bool
+checkpoint::included (size_t i) const
+{
+  return !states_only || devices[i].type != CHECKPOINT_PAGES;
+}
+
+// Write the header and every device to STREAM.
+int
+checkpoint::write_sections (FILE * stream, uint64_t instructions,
+			    uint64_t time_ns, bool delta)
+{
+  struct checkpoint_header header;
+
+  out = stream;
+  failed = false;
+  incremental = delta;
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+  for (size_t i = 0; i < devices.size (); i++)
+    if (included (i))
+      header.sections++;
+  header.instructions = instructions;
+  header.time_ns = time_ns;
+  if (delta)
+    {
+      header.flags = CHECKPOINT_DELTA;
+      header.parent_instructions = parent_instructions;
+      strncpy (header.parent, base_name (parent.c_str ()),
+	       CHECKPOINT_PARENT_SIZE - 1);
+    }
+  io (header);
+
+  for (size_t i = 0; i < devices.size (); i++)
+    {
+      struct checkpoint_section s;
+      off_t start, stop;
+
+      if (!included (i))
+	continue;
+
+      memset (&s, 0, sizeof (s));
+      strncpy (s.name, devices[i].name, CHECKPOINT_NAME_SIZE - 1);
+      s.type = devices[i].type;
+
+      // The size is only known once the device is done.
+      start = ftello (out);
+      io (s);
+      devices[i].state->checkpoint_state (*this);
+      stop = ftello (out);
+
+      s.size = stop - start - sizeof (s);
+      if (fseeko (out, start, SEEK_SET) != 0)
+	failed = true;
+      io (s);
+      if (fseeko (out, stop, SEEK_SET) != 0)
+	failed = true;
+    }
+
+  out = NULL;
+  incremental = false;
+  return failed || ferror (stream) ? -1 : 0;
+}
+
+// Restore every device from the checkpoint mapped at MAP.
+int
+checkpoint::restore_sections (const char *file, const uint8_t * map,
+			      size_t size)
+{
+  const struct checkpoint_header *header =
+    (const struct checkpoint_header *) map;
+  std::vector < const struct checkpoint_section *>sections;
+  const uint8_t *p = map + sizeof (*header);
+  const uint8_t *limit = map + size;
+
+  if (size < sizeof (*header)
+      || memcmp (header->magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) != 0)
+    {
+      fprintf (stderr, "ArchC: %s is not a checkpoint file\n", file);
+      return -1;
+    }
+  incremental = header->flags & CHECKPOINT_DELTA;
+
+  for (uint32_t i = 0; i < header->sections; i++)
+    {
+      const struct checkpoint_section *s =
+	(const struct checkpoint_section *) p;
+
+      if ((size_t) (limit - p) < sizeof (*s)
+	  || (uint64_t) (limit - p) - sizeof (*s) < s->size)
+	{
+	  fprintf (stderr, "ArchC: %s is truncated\n", file);
+	  return -1;
+	}
+      sections.push_back (s);
+      p += sizeof (*s) + s->size;
+    }
+
+  for (size_t i = 0; i < devices.size (); i++)
+    {
+      const struct checkpoint_section *s = NULL;
+
+      if (!included (i))
+	continue;
+
+      for (size_t j = 0; j < sections.size () && s == NULL; j++)
+	if (strncmp (sections[j]->name, devices[i].name,
+		     CHECKPOINT_NAME_SIZE) == 0)
+	  s = sections[j];
+
+      if (s == NULL || s->type != devices[i].type)
+	{
+	  fprintf (stderr, "ArchC: %s has no state for %s\n", file,
+		   devices[i].name);
+	  return -1;
+	}
+
+      cursor = (const uint8_t *) (s + 1);
+      end = cursor + s->size;
+      failed = false;
+      devices[i].state->checkpoint_state (*this);
+      if (failed || cursor != end)
+	{
+	  fprintf (stderr, "ArchC: State of %s in %s does not match this "
+		   "platform\n", devices[i].name, file);
+	  return -1;
+	}
+    }
+
+  return 0;
+}
+
+int
+checkpoint::restore (const char *file)
+{
+  std::vector < std::string > chain;
+  struct checkpoint_header header;
+  std::string name = file;
+  uint64_t expected = 0;
+
+  // Find the full checkpoint at the bottom, then restore upwards.
+  for (;;)
+    {
+      if (read_header (name.c_str (), &header) != 0)
+	return -1;
+      if (!chain.empty () && header.instructions != expected)
+	{
+	  fprintf (stderr, "ArchC: %s is not the parent of %s anymore\n",
+		   name.c_str (), chain.back ().c_str ());
+	  return -1;
+	}
+      chain.push_back (name);
+      if (!(header.flags & CHECKPOINT_DELTA))
+	break;
+
+      expected = header.parent_instructions;
+      name = name.substr (0, name.size () - strlen (base_name (name.c_str ())))
+	+ header.parent;
+    }
+
+  for (size_t i = chain.size (); i > 0; i--)
+    if (restore_file (chain[i - 1].c_str ()) != 0)
+      return -1;
+  return 0;
+}
+
+int
+checkpoint::restore_file (const char *file)
+{
+  struct stat st;
+  void *map;
+  int fd, ret;
+
+  fd = open (file, O_RDONLY);
+  if (fd < 0 || fstat (fd, &st) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      if (fd >= 0)
+	close (fd);
+      return -1;
+    }
+
+  // Map it instead of reading it, so restoring costs what the devices
+  // copy out of it and not a pass over the whole file.
+  map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      fprintf (stderr, "ArchC: Unable to map %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  ret = restore_sections (file, (const uint8_t *) map, st.st_size);
+  cursor = end = NULL;
+  incremental = false;
+  if (ret == 0)
+    fprintf (stderr, "ArchC: Restored %s, taken after %llu instructions\n",
+	     file, (unsigned long long)
+	     ((const struct checkpoint_header *) map)->instructions);
+  munmap (map, st.st_size);
+  return ret;
+}
+
+int
+checkpoint::restore_state (const void *data, size_t size)
+{
+  int ret;
+
+  states_only = true;
+  ret = restore_sections ("snapshot", (const uint8_t *) data, size);
+  states_only = false;
+  cursor = end = NULL;
+  incremental = false;
+  return ret;
+}
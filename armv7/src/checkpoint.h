@@ -0,0 +1,169 @@
+// 'checkpoint.h' - Platform checkpoints
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "checkpoint_format.h"
+
+class checkpoint;
+
+// Anything with state worth keeping across runs.
+class checkpointable
+{
+public:
+
+  virtual ~checkpointable ()
+  {
+  }
+
+  // Save the state to C, or restore it from C, depending on which way
+  // C is going.  Both directions share the code by passing every field
+  // through checkpoint::io, so they can't get out of sync.
+  virtual void checkpoint_state (checkpoint & c) = 0;
+};
+
+// Saves and restores the state of every registered device, in the
+// format of checkpoint_format.h.  A checkpoint is taken between
+// instructions, so the core has no instruction half done, and restored
+// before the simulation starts.
+//
+// SystemC time can't be moved, so a restored platform starts over at
+// time zero.  Devices keep their timers relative to the last time they
+// were brought up to date, and bring them up to date when saved.
+//
+// Long runs can also be checkpointed every few seconds of host time, so
+// they can be resumed if the host goes away.  Only the first of those
+// is complete; the rest are deltas holding the memory written since the
+// one before, which is usually a small part of it.
+class checkpoint
+{
+public:
+
+  checkpoint ();
+
+  // Register DEVICE under NAME.  TYPE is CHECKPOINT_PAGES for memories,
+  // which go through save_page and restore_page.
+  void add (const char *name, checkpointable * device,
+	    uint32_t type = CHECKPOINT_STATE);
+
+  // Both return 0 on success and -1 on failure.  Restoring a delta
+  // restores its parents first.
+  int save (const char *file, uint64_t instructions, uint64_t time_ns);
+  int restore (const char *file);
+
+  // Save or restore the state of every device but memories, to STREAM
+  // or from the DATA it was written to.  Memories keep their own
+  // history for reverse execution.
+  int save_state (FILE * stream, uint64_t instructions, uint64_t time_ns);
+  int restore_state (const void *data, size_t size);
+
+  // Write BASE.1, BASE.2... every SECONDS of host time.
+  void set_periodic (const char *base, unsigned seconds);
+
+  // Called between instructions, every batch.
+  void poll (uint64_t instructions)
+  {
+    if (interval == 0 || ++batches % CHECK_BATCHES != 0)
+      return;
+    check (instructions);
+  }
+
+  bool saving () const
+  {
+    return out != NULL;
+  }
+
+  // Whether the checkpoint being saved or restored is a delta.  Memories
+  // then save every page written since the last checkpoint, and restore
+  // pages over what they hold.
+  bool delta () const
+  {
+    return incremental;
+  }
+
+  template < typename T > void io (T & value)
+  {
+    io_bytes (&value, sizeof (value));
+  }
+
+  void io_bytes (void *data, size_t size);
+
+  // Called by devices restoring state that doesn't fit them.
+  void mismatch ()
+  {
+    failed = true;
+  }
+
+  // Memory sections.  restore_page returns false after the last page,
+  // and DATA points into the checkpoint until restore returns.
+  void save_page (uint32_t offset, const void *data);
+  bool restore_page (uint32_t * offset, const void **data);
+
+private:
+
+  struct device
+  {
+    const char *name;
+    checkpointable *state;
+    uint32_t type;
+  };
+
+  std::vector < device > devices;
+
+  // Saving.
+  FILE *out;
+
+  // Restoring, from the section being read.
+  const uint8_t *cursor;
+  const uint8_t *end;
+
+  bool failed;
+  bool incremental;
+  bool states_only;
+
+  // Periodic checkpoints.  Host time is only looked at every
+  // CHECK_BATCHES batches.
+  static const unsigned CHECK_BATCHES = 4096;
+  const char *base;
+  unsigned interval;
+  unsigned batches;
+  unsigned sequence;
+  double last_time;
+
+  // The last checkpoint written, which the next delta goes on top of.
+  // Empty if there is none yet, or writing it failed.
+  std::string parent;
+  uint64_t parent_instructions;
+
+  void check (uint64_t instructions);
+  int write (const char *file, uint64_t instructions, uint64_t time_ns,
+	     bool delta);
+  int write_sections (FILE * stream, uint64_t instructions,
+		      uint64_t time_ns, bool delta);
+  bool included (size_t i) const;
+  int restore_file (const char *file);
+  int restore_sections (const char *file, const uint8_t * map, size_t size);
+};
+
+#endif // !CHECKPOINT_H.
@@ -0,0 +1,84 @@
+// 'checkpoint_format.h' - Checkpoint file format
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CHECKPOINT_FORMAT_H
+#define CHECKPOINT_FORMAT_H
+
+#include <stdint.h>
+
+// A checkpoint file holds the state of the whole platform, one section
+// per device:
+//
+//   struct checkpoint_header
+//   struct checkpoint_section, followed by size bytes [sections]
+//
+// The contents of a CHECKPOINT_STATE section are private to the device
+// that wrote it.  A CHECKPOINT_PAGES section is a sequence of struct
+// checkpoint_page, one for each memory page that is not all zeros;
+// missing pages are zero.  All fields are little-endian.  This header
+// is shared by the simulator and the checkpoint tools, so it must stay
+// valid C.
+//
+// A checkpoint with CHECKPOINT_DELTA set only makes sense on top of its
+// parent.  Its state sections are still complete, but its page sections
+// only hold the pages written since the parent was taken, zero or not;
+// every other page is whatever the parent says.  Parents may be deltas
+// themselves, down to a full checkpoint.
+
+#define CHECKPOINT_MAGIC "ARMCKP\0\4"
+#define CHECKPOINT_MAGIC_SIZE 8
+
+#define CHECKPOINT_NAME_SIZE 32
+#define CHECKPOINT_PAGE_SIZE 4096
+#define CHECKPOINT_PARENT_SIZE 256
+
+#define CHECKPOINT_STATE 0
+#define CHECKPOINT_PAGES 1
+
+// Header flags.
+#define CHECKPOINT_DELTA 1
+
+struct checkpoint_header
+{
+  char magic[CHECKPOINT_MAGIC_SIZE];
+  uint32_t sections;
+  uint32_t flags;
+  uint64_t instructions;	// Executed when the checkpoint was taken.
+  uint64_t time_ns;		// Simulated time at that point.
+
+  // Deltas only.  The parent file, relative to the directory of this
+  // one and NUL terminated, and when it was taken, to tell it from a
+  // later checkpoint written over it.
+  uint64_t parent_instructions;
+  char parent[CHECKPOINT_PARENT_SIZE];
+};
+
+struct checkpoint_section
+{
+  char name[CHECKPOINT_NAME_SIZE];	// NUL terminated.
+  uint32_t type;
+  uint32_t reserved;
+  uint64_t size;
+};
+
+struct checkpoint_page
+{
+  uint32_t offset;		// From the start of the device.
+  uint8_t data[CHECKPOINT_PAGE_SIZE];
+};
+
+#endif // !CHECKPOINT_FORMAT_H.
@@ -0,0 +1,179 @@
+// 'counters.cpp' - Always-on simulation counters
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "counters.h"
+#include "arm_isa.H"
+#include "arm_interrupts.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <string>
+#include <systemc.h>
+
+volatile sig_atomic_t sim_counters::dump_requested = 0;
+
+static const char *exception_names[sim_counters::N_EXCEPTIONS] = {
+  "reset", "undefined", "swi", "prefetch_abort", "data_abort", "irq", "fiq"
+};
+
+sim_counters::sim_counters ():
+n_devices (0), output (NULL), dumps (0)
+{
+  memset (opcodes, 0, sizeof (opcodes));
+  memset (modes, 0, sizeof (modes));
+  memset (exceptions, 0, sizeof (exceptions));
+  memset (devices, 0, sizeof (devices));
+}
+
+unsigned
+sim_counters::add_device (const char *name)
+{
+  if (n_devices == N_DEVICES)
+    {
+      fprintf (stderr, "ArchC: Too many devices for MMIO counters\n");
+      exit (1);
+    }
+
+  devices[n_devices].name = name;
+  return n_devices++;
+}
+
+void
+sim_counters::request_dump (int sig)
+{
+  dump_requested = 1;
+}
+
+void
+sim_counters::install_handlers (unsigned seconds)
+{
+  struct sigaction sa;
+
+  memset (&sa, 0, sizeof (sa));
+  sa.sa_handler = request_dump;
+  sa.sa_flags = SA_RESTART;
+  sigemptyset (&sa.sa_mask);
+  sigaction (SIGUSR1, &sa, NULL);
+
+  if (seconds)
+    {
+      struct itimerval period;
+
+      sigaction (SIGALRM, &sa, NULL);
+      period.it_interval.tv_sec = seconds;
+      period.it_interval.tv_usec = 0;
+      period.it_value = period.it_interval;
+      setitimer (ITIMER_REAL, &period, NULL);
+    }
+}
+
+void
+sim_counters::write_json (FILE * stream)
+{
+  uint64_t total = 0;
+  bool first;
+
+  for (unsigned i = 0; i < N_OPCODES; i++)
+    total += opcodes[i];
+
+  fprintf (stream, "{\n  \"timestamp\": %lu,\n  \"export\": %u,\n",
+	   (unsigned long) time (NULL), dumps);
+  fprintf (stream, "  \"sim_time_ns\": %.0f,\n",
+	   sc_time_stamp ().to_seconds () * 1e9);
+  fprintf (stream, "  \"instructions\": %llu,\n",
+	   (unsigned long long) total);
+
+  fprintf (stream, "  \"opcodes\": {");
+  first = true;
+  for (unsigned i = 1; i < N_OPCODES; i++)
+    {
+      if (opcodes[i] == 0)
+	continue;
+      fprintf (stream, "%s\n    \"%s\": %llu", first ? "" : ",",
+	       arm_parms::arm_isa::instr_table[i].ac_instr_name,
+	       (unsigned long long) opcodes[i]);
+      first = false;
+    }
+  fprintf (stream, "\n  },\n");
+
+  fprintf (stream, "  \"modes\": {");
+  first = true;
+  for (unsigned i = 0; i < N_MODES; i++)
+    {
+      arm_impl::processor_mode m;
+      const char *name;
+
+      m.mode = 0x10 | i;
+      name = m.currentMode_str ();
+      if (name == NULL)
+	continue;
+      fprintf (stream, "%s\n    \"%s\": %llu", first ? "" : ",", name,
+	       (unsigned long long) modes[i]);
+      first = false;
+    }
+  fprintf (stream, "\n  },\n");
+
+  fprintf (stream, "  \"exceptions\": {");
+  for (unsigned i = 0; i < N_EXCEPTIONS; i++)
+    fprintf (stream, "%s\n    \"%s\": %llu", i ? "," : "",
+	     exception_names[i], (unsigned long long) exceptions[i]);
+  fprintf (stream, "\n  },\n");
+
+  fprintf (stream, "  \"mmio\": {");
+  for (unsigned i = 0; i < n_devices; i++)
+    fprintf (stream, "%s\n    \"%s\": { \"reads\": %llu, \"writes\": %llu }",
+	     i ? "," : "", devices[i].name,
+	     (unsigned long long) devices[i].reads,
+	     (unsigned long long) devices[i].writes);
+  fprintf (stream, "\n  }\n}\n");
+}
+
+int
+sim_counters::dump ()
+{
+  std::string tmp;
+  FILE *f;
+
+  dumps++;
+
+  if (output == NULL)
+    {
+      write_json (stderr);
+      return 0;
+    }
+
+  tmp = std::string (output) + ".tmp";
+  f = fopen (tmp.c_str (), "w");
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write counters to %s: %s\n",
+	       tmp.c_str (), strerror (errno));
+      return -1;
+    }
+
+  write_json (f);
+  if (fclose (f) != 0 || rename (tmp.c_str (), output) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to write counters to %s: %s\n",
+	       output, strerror (errno));
+      return -1;
+    }
+  return 0;
+}
@@ -0,0 +1,124 @@
+// 'counters.h' - Always-on simulation counters
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include "arm_parms.H"
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Instruction mix, processor mode, exception and MMIO counters.  Unlike
+// the AC_STATS ones, they are plain arrays bumped on the dispatch path,
+// so they are always built in.  They are exported as JSON on SIGUSR1,
+// every --stats-interval seconds and at exit.
+class sim_counters
+{
+public:
+
+  static const unsigned N_OPCODES = arm_parms::AC_DEC_INSTR_NUMBER + 1;
+
+  // Mode numbers are 0x10 to 0x1F; the low nibble is enough.
+  static const unsigned N_MODES = 16;
+
+  // One per arm_impl::exception_type.
+  static const unsigned N_EXCEPTIONS = 7;
+
+  static const unsigned N_DEVICES = 16;
+
+  sim_counters ();
+
+  // Called once per dispatched instruction.
+  void instruction (unsigned id, unsigned mode)
+  {
+    opcodes[id]++;
+    modes[mode & (N_MODES - 1)]++;
+  }
+
+  void exception (unsigned type)
+  {
+    if (type < N_EXCEPTIONS)
+      exceptions[type]++;
+  }
+
+  // Register a bus device.  Returns the index for mmio_read/mmio_write.
+  unsigned add_device (const char *name);
+
+  void mmio_read (unsigned device)
+  {
+    devices[device].reads++;
+  }
+
+  void mmio_write (unsigned device)
+  {
+    devices[device].writes++;
+  }
+
+  // Where exports go.  NULL means stderr.
+  void set_output (const char *file)
+  {
+    output = file;
+  }
+
+  // Take over SIGUSR1 and, if SECONDS is not zero, set up a periodic
+  // export.  Must be called after the core installs its handlers.
+  void install_handlers (unsigned seconds);
+
+  // Export now if a signal asked for it.  Called between instructions.
+  void poll ()
+  {
+    if (dump_requested)
+      {
+	dump_requested = 0;
+	dump ();
+      }
+  }
+
+  // Write all counters as a JSON object.  Files are replaced
+  // atomically, so readers never see half an export.  Returns 0 on
+  // success and -1 on failure.
+  int dump ();
+
+private:
+
+  struct device
+  {
+    const char *name;
+    uint64_t reads;
+    uint64_t writes;
+  };
+
+  uint64_t opcodes[N_OPCODES];
+  uint64_t modes[N_MODES];
+  uint64_t exceptions[N_EXCEPTIONS];
+
+  device devices[N_DEVICES];
+  unsigned n_devices;
+
+  const char *output;
+  unsigned dumps;
+
+  static volatile sig_atomic_t dump_requested;
+
+  static void request_dump (int sig);
+
+  void write_json (FILE * stream);
+};
+
+#endif // !COUNTERS_H.
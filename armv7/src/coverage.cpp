@@ -0,0 +1,255 @@
+// 'coverage.cpp' - Guest code coverage
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "coverage.h"
+
+#include <errno.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+coverage_map::coverage_map ():
+last_base (1), last_bits (NULL)	// No page starts at 1.
+{
+}
+
+coverage_map::~coverage_map ()
+{
+  for (std::map < uint32_t, uint8_t * >::iterator it = pages.begin ();
+       it != pages.end (); ++it)
+    delete[]it->second;
+}
+
+uint8_t *
+coverage_map::page (uint32_t base)
+{
+  uint8_t *&bits = pages[base];
+
+  if (bits == NULL)
+    {
+      bits = new uint8_t[COVERAGE_PAGE_BYTES];
+      memset (bits, 0, COVERAGE_PAGE_BYTES);
+    }
+
+  last_base = base;
+  return bits;
+}
+
+bool
+coverage_map::covered (uint32_t pc) const
+{
+  std::map < uint32_t, uint8_t * >::const_iterator it =
+    pages.find (pc & ~(COVERAGE_PAGE_SIZE - 1));
+  unsigned n = (pc % COVERAGE_PAGE_SIZE) / 4;
+
+  return it != pages.end () && (it->second[n / 8] & (1 << (n % 8)));
+}
+
+int
+coverage_map::merge (const char *file)
+{
+  FILE *f = fopen (file, "rb");
+  struct coverage_header header;
+  struct coverage_page p;
+
+  if (f == NULL)
+    {
+      if (errno == ENOENT)
+	return 0;
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  if (fread (&header, sizeof (header), 1, f) != 1
+      || memcmp (header.magic, COVERAGE_MAGIC, COVERAGE_MAGIC_SIZE) != 0
+      || header.page_size != COVERAGE_PAGE_SIZE)
+    {
+      fprintf (stderr, "ArchC: %s is not a coverage file\n", file);
+      fclose (f);
+      return -1;
+    }
+
+  for (uint32_t i = 0; i < header.pages; i++)
+    {
+      uint8_t *bits;
+
+      if (fread (&p, sizeof (p), 1, f) != 1)
+	{
+	  fprintf (stderr, "ArchC: %s is truncated\n", file);
+	  fclose (f);
+	  return -1;
+	}
+
+      bits = page (p.base & ~(COVERAGE_PAGE_SIZE - 1));
+      for (unsigned j = 0; j < COVERAGE_PAGE_BYTES; j++)
+	bits[j] |= p.bits[j];
+    }
+
+  fclose (f);
+  return 0;
+}
+
+int
+coverage_map::save (const char *file)
+{
+  std::string tmp = std::string (file) + ".tmp";
+  struct coverage_header header;
+  struct coverage_page p;
+  FILE *f;
+
+  f = fopen (tmp.c_str (), "wb");
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write coverage to %s: %s\n",
+	       tmp.c_str (), strerror (errno));
+      return -1;
+    }
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, COVERAGE_MAGIC, COVERAGE_MAGIC_SIZE);
+  header.page_size = COVERAGE_PAGE_SIZE;
+  header.pages = pages.size ();
+  fwrite (&header, sizeof (header), 1, f);
+
+  for (std::map < uint32_t, uint8_t * >::iterator it = pages.begin ();
+       it != pages.end (); ++it)
+    {
+      p.base = it->first;
+      memcpy (p.bits, it->second, COVERAGE_PAGE_BYTES);
+      fwrite (&p, sizeof (p), 1, f);
+    }
+
+  if (ferror (f) || fclose (f) != 0 || rename (tmp.c_str (), file) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to write coverage to %s: %s\n",
+	       file, strerror (errno));
+      return -1;
+    }
+  return 0;
+}
+
+// What lcov reports for one source file.
+struct lcov_record
+{
+  std::map < unsigned, bool > lines;
+  std::vector < std::pair < std::string, unsigned > >functions;
+  std::vector < bool > function_hits;
+};
+
+int
+coverage_map::write_lcov (const char *file, symbol_table & symbols,
+			  line_table & lines)
+{
+  const std::vector < line_table::range > &ranges = lines.all ();
+  const std::vector < symbol_table::symbol > &syms = symbols.all ();
+  std::map < std::string, lcov_record > records;
+  FILE *f;
+
+  for (size_t i = 0; i < ranges.size (); i++)
+    {
+      const line_table::range & r = ranges[i];
+      bool hit = false;
+
+      if (r.line == 0)
+	continue;
+      for (uint32_t pc = r.start & ~3; pc < r.end && !hit; pc += 4)
+	hit = covered (pc);
+
+      bool & line = records[lines.file_name (r.file)].lines[r.line];
+      line = line || hit;
+    }
+
+  for (size_t i = 0; i < syms.size (); i++)
+    {
+      const line_table::range * r;
+      lcov_record *rec;
+
+      if (!syms[i].code)
+	continue;
+
+      r = lines.lookup (syms[i].addr);
+      if (r != NULL)
+	rec = &records[lines.file_name (r->file)];
+      else
+	rec = &records[symbols.file_name (syms[i].file)];
+
+      rec->functions.push_back (std::make_pair (syms[i].name,
+						r ? r->line : 0));
+      rec->function_hits.push_back (covered (syms[i].addr));
+    }
+
+  f = fopen (file, "w");
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  for (std::map < std::string, lcov_record >::iterator it = records.begin ();
+       it != records.end (); ++it)
+    {
+      lcov_record & rec = it->second;
+      unsigned hit = 0;
+
+      fprintf (f, "TN:\nSF:%s\n", it->first.c_str ());
+
+      for (size_t i = 0; i < rec.functions.size (); i++)
+	fprintf (f, "FN:%u,%s\n", rec.functions[i].second,
+		 rec.functions[i].first.c_str ());
+      for (size_t i = 0; i < rec.functions.size (); i++)
+	{
+	  fprintf (f, "FNDA:%u,%s\n", (unsigned) rec.function_hits[i],
+		   rec.functions[i].first.c_str ());
+	  hit += rec.function_hits[i];
+	}
+      fprintf (f, "FNF:%u\nFNH:%u\n", (unsigned) rec.functions.size (), hit);
+
+      hit = 0;
+      for (std::map < unsigned, bool >::iterator l = rec.lines.begin ();
+	   l != rec.lines.end (); ++l)
+	{
+	  fprintf (f, "DA:%u,%u\n", l->first, (unsigned) l->second);
+	  hit += l->second;
+	}
+      fprintf (f, "LF:%u\nLH:%u\nend_of_record\n",
+	       (unsigned) rec.lines.size (), hit);
+    }
+
+  if (fclose (f) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to write %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+  return 0;
+}
+
+void
+coverage_map::print_stats (FILE * stream) const
+{
+  unsigned long long executed = 0;
+
+  for (std::map < uint32_t, uint8_t * >::const_iterator it = pages.begin ();
+       it != pages.end (); ++it)
+    for (unsigned i = 0; i < COVERAGE_PAGE_BYTES; i++)
+      executed += __builtin_popcount (it->second[i]);
+
+  fprintf (stream, "ArchC: Coverage: %llu instruction addresses in %u pages\n",
+	   executed, (unsigned) pages.size ());
+}
@@ -0,0 +1,80 @@
+// 'coverage.h' - Guest code coverage
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include "coverage_format.h"
+#include "lines.h"
+#include "symtab.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+
+// Executed instruction addresses, one bit each, in pages allocated on
+// first use.  The core marks every instruction it fetches, which costs
+// a compare and an OR while it stays in the same page.  At exit, the
+// bitmap is saved for later merging and mapped to source lines for
+// lcov.
+class coverage_map
+{
+public:
+
+  coverage_map ();
+  ~coverage_map ();
+
+  void hit (uint32_t pc)
+  {
+    uint32_t base = pc & ~(COVERAGE_PAGE_SIZE - 1);
+    unsigned n = (pc % COVERAGE_PAGE_SIZE) / 4;
+
+    if (base != last_base)
+      last_bits = page (base);
+    last_bits[n / 8] |= 1 << (n % 8);
+  }
+
+  bool covered (uint32_t pc) const;
+
+  // OR in a bitmap saved by an earlier run.  A missing file is not an
+  // error.  Returns 0 on success and -1 on failure.
+  int merge (const char *file);
+
+  // Write the bitmap.  Files are replaced atomically.  Returns 0 on
+  // success and -1 on failure.
+  int save (const char *file);
+
+  // Write an lcov tracefile.  Code with line information is reported
+  // by source line, functions by their symbols; functions without line
+  // information are listed under the ELF they come from.  Returns 0 on
+  // success and -1 on failure.
+  int write_lcov (const char *file, symbol_table & symbols,
+		  line_table & lines);
+
+  void print_stats (FILE * stream) const;
+
+private:
+
+  std::map < uint32_t, uint8_t * >pages;
+
+  uint32_t last_base;
+  uint8_t *last_bits;
+
+  uint8_t *page (uint32_t base);
+};
+
+#endif // !COVERAGE_H.
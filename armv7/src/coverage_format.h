@@ -0,0 +1,54 @@
+// 'coverage_format.h' - Code coverage bitmap format
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef COVERAGE_FORMAT_H
+#define COVERAGE_FORMAT_H
+
+#include <stdint.h>
+
+// A coverage file holds one bit per instruction address, for the pages
+// where anything ran:
+//
+//   struct coverage_header
+//   struct coverage_page [pages]
+//
+// Bit N of a page (bits[N / 8] & (1 << N % 8)) is set if the
+// instruction at base + 4 * N was executed.  Files are merged by OR-ing
+// pages with the same base.  All fields are little-endian.  This header
+// is shared by the simulator and the covmerge tool, so it must stay
+// valid C.
+
+#define COVERAGE_MAGIC "ARMCOV\0\1"
+#define COVERAGE_MAGIC_SIZE 8
+
+#define COVERAGE_PAGE_SIZE 4096
+#define COVERAGE_PAGE_BYTES (COVERAGE_PAGE_SIZE / 4 / 8)
+
+struct coverage_header
+{
+  char magic[COVERAGE_MAGIC_SIZE];
+  uint32_t page_size;
+  uint32_t pages;
+};
+
+struct coverage_page
+{
+  uint32_t base;
+  uint8_t bits[COVERAGE_PAGE_BYTES];
+};
+
+#endif // !COVERAGE_FORMAT_H.
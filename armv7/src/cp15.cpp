@@ -22,8 +22,12 @@
 // ----------------------------------------------------------------------
 
 #include "cp15.h"
+#include "idle.h"
+#include "pmu.h"
 
 extern bool DEBUG_CP15;
+extern idle_detector *idle_det;
+extern pmu *perfmon;
 
 #define dprintf(args...) if(DEBUG_CP15){fprintf(stderr,args);}
 
@@ -31,10 +35,18 @@ extern bool DEBUG_CP15;
 #define CL_READ      0b01
 #define CL_WRITE     0b10
 
+// Legacy CP15 wait for interrupt operation.
+void
+cp15::wait_for_interrupt (struct cp15_register *reg, uint32_t * datum)
+{
+  if (idle_det)
+    idle_det->wfi ();
+}
+
 cp15::cp15 (sc_module_name name_): sc_module (name_)
 {
 
-  memset (registers, 0, 0xFFFF);
+  memset (registers, 0, sizeof (registers));
   reset ();
 }
 
@@ -77,19 +89,10 @@ cp15::reset ()
   registers[SECURE_DEBUG_ENABLED].value = 0x00000000;
   registers[NONSECURE_ACCESS_CONTROL].value = 0x00000000;
 
+  registers[NOP_WFI].write_callback = wait_for_interrupt;
   registers[PHYSICAL_ADDRESS].value = 0x00000000 ;
 
-  registers[PERFORMANCE_MONITOR_CONTROL].value = 0x41002000 ;
-  registers[COUNT_ENABLE_SET].value = 0x00000000;
-  registers[COUNT_ENABLE_CLEAR].value = 0x00000000;
-  registers[OVERFLOW_FLAG_STATUS].value = 0x00000000;
-  registers[SOFTWARE_INCREMENT].value = 0x00000000;
-  registers[CYCLE_COUNT].value = 0x00000000;
-
-  registers[PERFORMANCE_MONITOR_COUNT].value = 0x00000000;
-  registers[USER_ENABLE].value = 0x00000000;
-  registers[INTERRUPT_ENABLE_SET].value = 0x00000000;
-  registers[INTERRUPT_ENABLE_CLEAR].value = 0x00000000;
+  // Performance monitor registers live in the PMU model.
 
   registers[L2_CACHE_LOCKDOWN].value = 0x00000000;
   registers[L2_CACHE_AUXILIARY_CONTROL].value = 0x00000042;
@@ -138,6 +141,12 @@ cp15::MCR (arm_arch_ref * core,
   //     service_interrupt (*core, arm_impl::EXCEPTION_UNDEFINED_INSTR);
   //   }
 
+  if (perfmon && pmu::is_register (reg - registers))
+    {
+      perfmon->write (reg - registers, rt_value);
+      return;
+    }
+
   if (reg->write_callback)
     reg->write_callback (reg, &rt_value);
 
@@ -166,8 +175,49 @@ cp15::MRC (arm_arch_ref * core, const arm_impl::PrivilegeLevel pl,
   //     service_interrupt (*core, arm_impl::EXCEPTION_UNDEFINED_INSTR);
   //   }
 
+  if (perfmon && pmu::is_register (reg - registers))
+    return perfmon->read (reg - registers);
+
   if (reg->read_callback)
     reg->read_callback (reg);
 
   return reg->value;
 }
+
+void
+cp15::checkpoint_state (checkpoint & c)
+{
+  const uint32_t n = sizeof (registers) / sizeof (registers[0]);
+  uint32_t count = 0;
+
+  // Most of the space is unused, so only keep what is set, as
+  // (index, value) pairs.
+  if (c.saving ())
+    for (uint32_t i = 0; i < n; i++)
+      if (registers[i].value != 0)
+        count++;
+  c.io (count);
+
+  if (c.saving ())
+    {
+      for (uint32_t i = 0; i < n; i++)
+        if (registers[i].value != 0)
+          {
+            c.io (i);
+            c.io (registers[i].value);
+          }
+      return;
+    }
+
+  for (uint32_t i = 0; i < n; i++)
+    registers[i].value = 0;
+  for (uint32_t j = 0; j < count; j++)
+    {
+      uint32_t i, value;
+
+      c.io (i);
+      c.io (value);
+      if (i < n)
+        registers[i].value = value;
+    }
+}
@@ -30,8 +30,9 @@
 #include "ac_stats_base.H"
 #include "arm_interrupts.h"
 #include "coprocessor.h"
+#include "checkpoint.h"
 
-class cp15: public coprocessor, public sc_module
+class cp15: public coprocessor, public sc_module, public checkpointable
 {
  public:
   static const int MAIN_ID                      = 0x0000;
@@ -178,6 +179,10 @@ class cp15: public coprocessor, public sc_module
 
   void reset ();
 
+  // Register callbacks.
+  static void wait_for_interrupt (struct cp15_register *reg,
+                                  uint32_t * datum);
+
   struct cp15_register *getRegister (const unsigned opc1,
                                      const unsigned opc2,
                                      const unsigned crn,
@@ -196,6 +201,9 @@ public:
 
   uint32_t getRegisterValue (const unsigned hash)
   {return registers[hash].value;};
+
+  // Register values.  Permissions and callbacks are set up by reset.
+  void checkpoint_state (checkpoint & c);
 };
 
 #endif // !CP15_H.
@@ -29,12 +29,13 @@
 #include <systemc.h>
 #include <ac_tlm_protocol.H>
 #include "tzic.h"
+#include "checkpoint.h"
 
 // This is a dumb DPLLC reacting as described by iMX53 QSB iMXRM manual.
 // It does not actually performs any action, since our model is not clock accurated.
 // We just respond to Core as if the command was executed.
 
-class dpllc_module:public sc_module, public peripheral
+class dpllc_module:public sc_module, public peripheral, public checkpointable
 {
 private:
   tzic_module & tzic;
@@ -66,6 +67,11 @@ public:
   }
 
   dpllc_module (sc_module_name name_, tzic_module & tzic_);
+
+  void checkpoint_state (checkpoint & c)
+  {
+    c.io (regs);
+  }
 };
 
 #endif // !DPLLC_H
@@ -23,6 +23,7 @@
 
 #include "esdhcv2.h"
 #include "arm_interrupts.h"
+#include "host_profile.h"
 
 extern bool DEBUG_ESDHCV2;
 #define dprintf(args...)         \
@@ -53,6 +54,8 @@ esdhc_module::reset_DAT_line ()
   //Clear data port
   while (ibuffer.size () > 0)
     ibuffer.pop ();
+  while (obuffer.size () > 0)
+    obuffer.pop ();
 }
 
 // Append a new card to Data port and signals to host a new card was
@@ -87,8 +90,13 @@ esdhc_module::prc_ESDHCV2 ()
   do
     {
       ///      dprintf ("-------------------- ESDHCV2 -------------------- \n");
-      wait (1, SC_NS);
+      // Sleep until a transfer starts.
+      if (current_state == IDLE)
+	wait (transfer_started);
+      else
+	wait (1, SC_NS);
 
+      HOST_PROFILE_SCOPE (HP_ESDHC);
       if (current_state == IDLE)
 	continue;
 
@@ -139,8 +147,33 @@ esdhc_module::sd_protocol ()
     }
   else if (current_state == HOST_WRITE)
     {
-      printf ("ESDHC WRITE not implement in this model");
-      exit (1);
+      // Hand a full block to the card, if it can take it.
+      if (obuffer.size () >= BLKSIZE
+          && port->write_dataline (obuffer, BLKSIZE))
+	{
+	  // Multiple block transfer.
+	  if (MSBSEL == true)
+	    {
+	      //If necessary reduce BlockCount and issue AUTOCMD12
+	      if (BCEN == true)
+		{
+		  BLKCNT = BLKCNT - 1;
+
+		  if (BLKCNT == 0)
+		    {
+		      // Issue AUTOCMD12.
+		      port->exec_cmd (12, 0b11, regs[CMDARG / 4]);
+
+		      BLKCNT = BLKCNT_BKP;
+		      update_state (HOST_WRITE_DONE);
+		    }
+		}
+	    }
+	  else
+	    {
+	      update_state (HOST_WRITE_DONE);
+	    }
+	}
     }
 }
 
@@ -163,6 +196,24 @@ esdhc_module::host_protocol ()
 	  update_state (IDLE);
 	}
     }
+  else if (current_state == HOST_WRITE)
+    {
+      // Ask for more data once the current block left the buffer.
+      if (!BWEN && obuffer.size () < BLKSIZE)
+	{
+	  BWEN = true;
+	  generate_signal (IRQ_BWR);
+	}
+    }
+  else if (current_state == HOST_WRITE_DONE)
+    {
+      // Operation is complete once the card consumed the last block.
+      if (port->data_line_busy == false)
+	{
+	  generate_signal (IRQ_TC);
+	  update_state (IDLE);
+	}
+    }
 }
 
 void
@@ -250,12 +301,34 @@ esdhc_module::update_state (const enum state new_state)
     }
   else if (new_state == HOST_WRITE)
     {
-      fprintf (stderr, "%s: WRITE not implement in this model",
-               this->name());
-      exit (1);
+      // Signal DLA will be used.
+      DLA = true;
+
+      // Signal direction as WRITE.
+      WTA = true;
+
+      // Prevent from receiving further data transfer commands.
+      CDIHB = true;
+
+      // Buffer is empty.  Ask the host for data.
+      BWEN = true;
+      generate_signal (IRQ_BWR);
+
+      current_state = HOST_WRITE;
+    }
+  else if (new_state == HOST_WRITE_DONE)
+    {
+      BWEN = false;
+      current_state = HOST_WRITE_DONE;
     }
   else if (new_state == IDLE)
     {
+      if (current_state == HOST_WRITE_DONE)
+	{
+	  DLA = false;
+	  WTA = false;
+	  CDIHB = false;
+	}
       current_state = IDLE;
     }
   else
@@ -263,6 +336,9 @@ esdhc_module::update_state (const enum state new_state)
       fprintf (stderr, "%s: State %d not implemented!",
                this->name(), new_state);
     }
+
+  if (current_state != IDLE)
+    transfer_started.notify (1, SC_NS);
 }
 
 void
@@ -450,6 +526,18 @@ esdhc_module::fast_write (unsigned address, unsigned datum)
     case DSADR:
       regs[DSADR / 4] = datum & ~(0b11);
       break;
+
+    case DATPORT:
+      if (current_state != HOST_WRITE)
+	break;
+
+      for (int i = 0; i < 4; i++)
+	obuffer.push ((datum >> (8 * i)) & 0xFF);
+
+      // Buffer holds a whole block.  Wait until the card takes it.
+      if (obuffer.size () >= BLKSIZE)
+	BWEN = false;
+      break;
     case CMDARG:
       if (!CIHB)
 	regs[CMDARG / 4] = datum;
@@ -568,3 +656,111 @@ esdhc_module::fast_write (unsigned address, unsigned datum)
     }
   dprintf ("\n");
 }
+
+static void
+checkpoint_queue (checkpoint & c, std::queue < unsigned char >&q)
+{
+  uint32_t size = q.size ();
+
+  c.io (size);
+  if (c.saving ())
+    {
+      // Rotate it, so it ends up as it was.
+      for (uint32_t i = 0; i < size; i++)
+	{
+	  unsigned char byte = q.front ();
+
+	  c.io (byte);
+	  q.pop ();
+	  q.push (byte);
+	}
+      return;
+    }
+
+  while (!q.empty ())
+    q.pop ();
+  for (uint32_t i = 0; i < size; i++)
+    {
+      unsigned char byte;
+
+      c.io (byte);
+      q.push (byte);
+    }
+}
+
+void
+esdhc_module::checkpoint_state (checkpoint & c)
+{
+  c.io (current_state);
+  c.io (regs);
+  c.io (DMAEN);
+  c.io (BCEN);
+  c.io (AC12EN);
+  c.io (DTDSEL);
+  c.io (MSBSEL);
+  c.io (RSPTYP);
+  c.io (CCCEN);
+  c.io (CICEN);
+  c.io (DPSEL);
+  c.io (CMDTYP);
+  c.io (CMDINX);
+  c.io (DLSL);
+  c.io (CLSL);
+  c.io (WPSPL);
+  c.io (CDPL);
+  c.io (CINS);
+  c.io (BREN);
+  c.io (BWEN);
+  c.io (RTA);
+  c.io (WTA);
+  c.io (SDOFF);
+  c.io (PEROFF);
+  c.io (HCKOFF);
+  c.io (IPGOFF);
+  c.io (SDSTB);
+  c.io (DLA);
+  c.io (CDIHB);
+  c.io (CIHB);
+  c.io (WECRM);
+  c.io (WECINS);
+  c.io (WECINT);
+  c.io (IABG);
+  c.io (RWCTL);
+  c.io (CREQ);
+  c.io (SABGREQ);
+  c.io (DMAS);
+  c.io (CDSS);
+  c.io (CDTL);
+  c.io (EMODE);
+  c.io (D3CD);
+  c.io (DTW);
+  c.io (LCTL);
+  c.io (INITA);
+  c.io (RSTD);
+  c.io (RSTC);
+  c.io (RSTA);
+  c.io (DTOCV);
+  c.io (SDCLKFS);
+  c.io (DVS);
+  c.io (SDCLKEN);
+  c.io (PEREN);
+  c.io (HCKEN);
+  c.io (IPGEN);
+  c.io (WR_BRST_LEN);
+  c.io (WR_WML);
+  c.io (RD_BRST_LEN);
+  c.io (RD_WML);
+  c.io (ADMADCE);
+  c.io (ADMALME);
+  c.io (ADMAES);
+  c.io (BLKCNT);
+  c.io (BLKSIZE);
+  c.io (BLKCNT_BKP);
+  checkpoint_queue (c, ibuffer);
+  checkpoint_queue (c, obuffer);
+
+  // Restored while running, when GDB goes back in time.  The thread may
+  // be sleeping on an idle present while the past has a transfer going.
+  if (!c.saving () && current_state != IDLE)
+    transfer_started.notify (1, SC_NS);
+}
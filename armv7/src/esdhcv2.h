@@ -27,12 +27,15 @@
 #include <stdint.h>
 #include "peripheral.h"
 #include "tzic.h"
+#include "idle.h"
 #include <systemc.h>
 #include <ac_tlm_protocol.H>
 #include "sd.h"
 #include <queue>
+#include "checkpoint.h"
 
-class esdhc_module:public sc_module, public peripheral
+class esdhc_module:public sc_module, public peripheral, public idle_source,
+  public checkpointable
 {
   enum state
   {
@@ -67,6 +70,9 @@ class esdhc_module:public sc_module, public peripheral
 
   enum state current_state;
 
+  // Notified when leaving IDLE.
+  sc_event transfer_started;
+
   // Internal Registers
   static const uint32_t DSADR = 0x00;	// DMA System Address
   static const uint32_t BLKATTR = 0x04;	// Block attribute
@@ -184,6 +190,7 @@ class esdhc_module:public sc_module, public peripheral
 
   sd_card *port;
     std::queue < unsigned char >ibuffer;
+    std::queue < unsigned char >obuffer;
 
   // This port is used to send interrupts to the processor
     tzic_module & tzic;
@@ -219,6 +226,16 @@ public:
 
   void connect_card (sd_card *card);
 
+  // Registers, decoded fields and the data buffers.  The card saves
+  // its own state.
+  void checkpoint_state (checkpoint & c);
+
+  // Transfers in flight advance every cycle.
+  uint64_t next_event_ns ()
+  {
+    return current_state == IDLE ? NO_EVENT : 0;
+  }
+
 private:
 
   void reset_DAT_line ();
@@ -23,6 +23,7 @@
 
 #include "gpt.h"
 #include "arm_interrupts.h"
+#include "host_profile.h"
 #include <time.h>
 
 extern bool DEBUG_GPT;
@@ -65,101 +66,199 @@ gpt_module::set_output_pin (bool & output, oc_operation_mode_t mode)
     }
 }
 
+// Process one counter tick.
 void
-gpt_module::prc_gpt ()
+gpt_module::tick ()
 {
-  do
+  dprintf ("-------------------- GPT --------------------- \n");
+  dprintf ("Counter value: 0x%X\n", counter);
+  // Compare counter logic
+  if (counter == 0xFFFFFFFF)
+    {
+      *(regs + GPT_SR / 4) |= (1 << 5);
+      dprintf ("Counter rolled over.\n");
+    }
+  if (counter == *(regs + GPT_OCR1 / 4))
     {
-      wait (1, SC_NS);
+      *(regs + GPT_SR / 4) |= (1 << 0);
+      set_output_pin (do_cmpout1, om1);
+      dprintf ("Counter output_compare_1 event generated.\n");
+    }
+  else if (counter == *(regs + GPT_OCR2 / 4))
+    {
+      *(regs + GPT_SR / 4) |= (1 << 1);
+      set_output_pin (do_cmpout2, om2);
+      dprintf ("Counter output_compare_2 event generated.\n");
+    }
+  else if (counter == *(regs + GPT_OCR3 / 4))
+    {
+      *(regs + GPT_SR / 4) |= (1 << 2);
+      set_output_pin (do_cmpout3, om3);
+      dprintf ("Counter output_compare_3 event generated.\n");
+    }
+  // Update counter logic
+  if (counter_mode == M_RESTART && counter == *(regs + GPT_OCR1 / 4))
+    {
+      counter = 0;
+    }
+  else
+    {
+      if (counter == 0xFFFFFFFF)
+	counter = 0;
+      else
+	++counter;
+    }
 
-      if (!enabled)
-	continue;
+  update_interrupt ();
+}
 
-      if (clock_src == CLK_OFF || clock_src == EXTERNAL_CLK)
-	continue;
+void
+gpt_module::update_interrupt ()
+{
+  // Generate interrupts
+  if (*(regs + GPT_IR / 4) & *(regs + GPT_SR / 4))
+    {
+      tzic.interrupt (GPT_IRQNUM, /*deassert= */ false);
+      dprintf ("Asserted interrupt line in TZIC.\n");
+    }
+  else
+    {
+      tzic.interrupt (GPT_IRQNUM, /*deassert= */ true);
+    }
+}
 
-      dprintf ("-------------------- GPT --------------------- \n");
-      dprintf ("Prescaler counter value: 0x%X\n", prescaler_counter);
-      bool prescaler_tick = false;
-      if (prescaler_counter == prescaler)
-	{
-	  prescaler_tick = true;
-	  prescaler_counter = 0;
-	  dprintf ("Prescaler ticked.\n");
-	}
-      else if (prescaler_counter >= 4096)
-	{
-	  prescaler_counter = 0;
-	}
-      else
-	{
-	  ++prescaler_counter;
-	}
+bool
+gpt_module::running () const
+{
+  return enabled && clock_src != CLK_OFF && clock_src != EXTERNAL_CLK;
+}
 
-      if (!prescaler_tick)
-	continue;
+// Number of ticks before the counter hits a compare value or rolls
+// over.  Ticks in between only increment the counter.
+uint64_t
+gpt_module::ticks_to_event () const
+{
+  const unsigned targets[] = { *(regs + GPT_OCR1 / 4), *(regs + GPT_OCR2 / 4),
+    *(regs + GPT_OCR3 / 4), 0xFFFFFFFF
+  };
+  uint64_t next = 0x100000000ULL;
 
-      dprintf ("Counter value: 0x%X\n", counter);
-      // Compare counter logic
-      if (counter == 0xFFFFFFFF)
-	{
-	  *(regs + GPT_SR / 4) |= (1 << 5);
-	  dprintf ("Counter rolled over.\n");
-	}
-      if (counter == *(regs + GPT_OCR1 / 4))
-	{
-	  *(regs + GPT_SR / 4) |= (1 << 0);
-	  set_output_pin (do_cmpout1, om1);
-	  dprintf ("Counter output_compare_1 event generated.\n");
-	}
-      else if (counter == *(regs + GPT_OCR2 / 4))
-	{
-	  *(regs + GPT_SR / 4) |= (1 << 1);
-	  set_output_pin (do_cmpout2, om2);
-	  dprintf ("Counter output_compare_2 event generated.\n");
-	}
-      else if (counter == *(regs + GPT_OCR3 / 4))
-	{
-	  *(regs + GPT_SR / 4) |= (1 << 2);
-	  set_output_pin (do_cmpout3, om3);
-	  dprintf ("Counter output_compare_3 event generated.\n");
-	}
-      // Update counter logic
-      if (counter_mode == M_RESTART && counter == *(regs + GPT_OCR1 / 4))
-	{
-	  counter = 0;
-	}
-      else
-	{
-	  if (counter == 0xFFFFFFFF)
-	    counter = 0;
-	  else
-	    ++counter;
-	}
-      // Generate interrupts
-      bool gen_interrupt = false;
-      if (*(regs + GPT_IR / 4) & *(regs + GPT_SR / 4))
-	gen_interrupt = true;
-      if (gen_interrupt)
+  for (int i = 0; i < 4; i++)
+    {
+      uint64_t d = (unsigned) (targets[i] - counter);
+      if (d < next)
+	next = d;
+    }
+  return next;
+}
+
+// Time until the next tick that does more than incrementing the
+// counter.
+uint64_t
+gpt_module::ns_to_event () const
+{
+  if (!running ())
+    return NO_EVENT;
+
+  return (prescaler - prescaler_counter + 1)
+    + ticks_to_event () * ((uint64_t) prescaler + 1);
+}
+
+// Run the timer for NS platform cycles.  The prescaler and quiet ticks
+// are computed in bulk, only event ticks are processed one by one.
+void
+gpt_module::advance (uint64_t ns)
+{
+  uint64_t period = (uint64_t) prescaler + 1;
+  uint64_t to_tick = prescaler - prescaler_counter + 1;
+  uint64_t ticks;
+
+  if (!running ())
+    return;
+
+  if (ns < to_tick)
+    {
+      prescaler_counter += ns;
+      return;
+    }
+
+  ns -= to_tick;
+  ticks = 1 + ns / period;
+  prescaler_counter = ns % period;
+
+  while (ticks > 0)
+    {
+      uint64_t quiet = ticks_to_event ();
+      if (quiet >= ticks)
 	{
-	  tzic.interrupt (GPT_IRQNUM, /*deassert= */ false);
-	  dprintf ("Asserted interrupt line in TZIC.\n");
+	  counter += ticks;
+	  break;
 	}
+      counter += quiet;
+      ticks -= quiet + 1;
+      tick ();
+    }
+}
+
+// Bring the timer state up to the current simulation time.
+void
+gpt_module::catch_up ()
+{
+  sc_time now = sc_time_stamp ();
+  uint64_t ns = (now - last_update).value () / sc_time (1, SC_NS).value ();
+
+  last_update = now;
+  advance (ns);
+}
+
+// The timer sleeps until its next event instead of waking up every
+// cycle.  Register accesses catch up on their own and reschedule it.
+void
+gpt_module::prc_gpt ()
+{
+  do
+    {
+      uint64_t next;
+
+      {
+	HOST_PROFILE_SCOPE (HP_GPT);
+	catch_up ();
+	next = ns_to_event ();
+      }
+
+      if (next == NO_EVENT)
+	wait (reconfigured);
       else
-	{
-	  tzic.interrupt (GPT_IRQNUM, /*deassert= */ true);
-	}
+	wait (sc_time ((double) next, SC_NS), reconfigured);
     }
   while (1);
 }
 
+uint64_t
+gpt_module::next_event_ns ()
+{
+  catch_up ();
+
+  // Someone is watching the counter itself, every tick is an event.
+  if (cnt_polled && running ())
+    {
+      cnt_polled = false;
+      return prescaler - prescaler_counter + 1;
+    }
+
+  return ns_to_event ();
+}
+
 unsigned
 gpt_module::fast_read (unsigned address)
 {
   unsigned res = 0;
+
+  catch_up ();
   switch (address)
     {
     case GPT_CNT:
+      cnt_polled = true;
       return counter;
       break;
     default:
@@ -171,6 +270,7 @@ gpt_module::fast_read (unsigned address)
 void
 gpt_module::fast_write (unsigned address, unsigned datum)
 {
+  catch_up ();
   switch (address)
     {
     case GPT_CR:
@@ -233,13 +333,18 @@ gpt_module::fast_write (unsigned address, unsigned datum)
       *(regs + address / 4) = datum;
       break;
     case GPT_PR:
-      prescaler = datum;
+      prescaler = datum & 0xFFF;
       prescaler_counter = 0;
       // fall through
     default:
       *(regs + address / 4) = datum;
     }
 
+  if (running ())
+    update_interrupt ();
+
+  // Wake the timer thread up to compute its next event again.
+  reconfigured.notify (SC_ZERO_TIME);
 }
 
 
@@ -266,3 +371,38 @@ gpt_module::ind_capin2 (bool deassert)
       *(regs + GPT_SR / 4) |= (1 << 4);
     }
 }
+
+// The timer is saved up to date, and goes on from the current time when
+// restored.
+void
+gpt_module::checkpoint_state (checkpoint & c)
+{
+  if (c.saving ())
+    catch_up ();
+  else
+    last_update = sc_time_stamp ();
+
+  c.io (regs);
+  c.io (counter);
+  c.io (prescaler);
+  c.io (prescaler_counter);
+  c.io (clock_src);
+  c.io (om1);
+  c.io (om2);
+  c.io (om3);
+  c.io (im1);
+  c.io (im2);
+  c.io (counter_mode);
+  c.io (stop_en);
+  c.io (wait_en);
+  c.io (dbg_en);
+  c.io (en_mode);
+  c.io (enabled);
+  c.io (cnt_polled);
+  c.io (do_cmpout1);
+  c.io (do_cmpout2);
+  c.io (do_cmpout3);
+
+  if (!c.saving ())
+    reconfigured.notify (SC_ZERO_TIME);
+}
@@ -26,9 +26,11 @@
 
 #include "peripheral.h"
 #include "tzic.h"
+#include "idle.h"
 
 #include <systemc.h>
 #include <ac_tlm_protocol.H>
+#include "checkpoint.h"
 
 // In this model, we mimic the behavior of the GPT IP for generating
 // timer triggered interrupts, communicating directly with the TZIC IC via
@@ -40,7 +42,8 @@
 // More info about this module:
 // Please refer to iMX53 Reference Manual page 1735
 //
-class gpt_module:public sc_module, public peripheral
+class gpt_module:public sc_module, public peripheral, public idle_source,
+  public checkpointable
 {
 private:
 
@@ -67,6 +70,12 @@ private:
   // 12-bit prescaler
   unsigned prescaler, prescaler_counter;
 
+  // Simulation time the state above corresponds to.
+  sc_time last_update;
+
+  // Notified when registers are written.
+  sc_event reconfigured;
+
   enum selected_clock_t
   { CLK_OFF = 0, PERIPHERAL_CLK = 1, HI_FREQ = 2, EXTERNAL_CLK = 3,
     LOW_FREQ = 4
@@ -94,6 +103,7 @@ private:
   bool dbg_en;			// true if gpt is enabled in dbg mode
   bool en_mode;			// true if gpt resets when re-enabled
   bool enabled;			// freezes counters if false
+  bool cnt_polled;		// GPT_CNT was read since last idle check
 
   void do_reset (bool hard_reset = true)
   {
@@ -114,6 +124,7 @@ private:
 	enabled = false;
       }
 
+    cnt_polled = false;
     do_cmpout1 = false;
     do_cmpout2 = false;
     do_cmpout3 = false;
@@ -134,6 +145,16 @@ private:
 
   void set_output_pin (bool & output, oc_operation_mode_t mode);
 
+  // Timer evolution.  Rather than ticking every cycle, the state is
+  // brought up to date on register accesses and on the next event.
+  bool running () const;
+  void tick ();
+  void update_interrupt ();
+  uint64_t ticks_to_event () const;
+  uint64_t ns_to_event () const;
+  void advance (uint64_t ns);
+  void catch_up ();
+
   // Fast read/write don't implement error checking. The bus (or other caller)
   // must ensure the address is valid.
   // Invalid read/writes are treated as no-ops.
@@ -157,6 +178,11 @@ public:
   // This is the main process to simulate the IP behavior
   void prc_gpt ();
 
+  // Time until the next compare or rollover event.
+  uint64_t next_event_ns ();
+
+  void checkpoint_state (checkpoint & c);
+
   // -- External signals
   // Two input capture with programmable edge trigger
   void ind_capin1 (bool deassert = false);
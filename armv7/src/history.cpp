@@ -0,0 +1,254 @@
+// 'history.cpp' - Execution history for reverse debugging
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "history.h"
+#include "ram.h"
+#include "quantum.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+extern quantum_keeper *qkeeper;
+
+// Snapshots are never taken closer than this, so a short window doesn't
+// turn every synchronization into one.
+static const uint64_t MIN_INTERVAL = 10000;
+
+// What a saved page costs, with its map entry.
+static const size_t PAGE_COST = ram_module::PAGE_SIZE + 64;
+
+history::history (checkpoint & platform_, size_t budget_, uint64_t window_):
+platform (platform_), budget (budget_), used (0), window (window_), next (0)
+{
+  // Start with 64 snapshots over the window.
+  min_interval = std::max (window / 64, MIN_INTERVAL);
+  interval = min_interval;
+}
+
+history::~history ()
+{
+  for (size_t i = 0; i < snapshots.size (); i++)
+    drop (snapshots[i]);
+  for (size_t i = 0; i < memories.size (); i++)
+    memories[i]->set_history (NULL);
+}
+
+void
+history::add (ram_module * ram)
+{
+  memories.push_back (ram);
+  ram->set_history (this);
+}
+
+void
+history::page_written (ram_module * ram, uint32_t page)
+{
+  snapshot *s;
+  uint64_t key;
+  unsigned char *copy;
+  size_t m = 0;
+
+  // Writes before the first snapshot can't be undone anyway.
+  if (snapshots.empty ())
+    return;
+
+  while (memories[m] != ram)
+    m++;
+  key = (uint64_t) m << 32 | page;
+
+  // Already there if the snapshot absorbed a later one.
+  s = snapshots.back ();
+  if (s->pages.count (key))
+    return;
+
+  copy = new unsigned char[ram_module::PAGE_SIZE];
+  memcpy (copy, ram->page_data (page), ram_module::PAGE_SIZE);
+  s->pages[key] = copy;
+  used += PAGE_COST;
+}
+
+void
+history::take (uint64_t instructions)
+{
+  if (instructions >= next)
+    {
+      snapshot *s;
+      char *state = NULL;
+      size_t size = 0;
+      FILE *f = open_memstream (&state, &size);
+
+      next = instructions + interval;
+      if (f == NULL
+	  || platform.save_state (f, instructions,
+				  (uint64_t) (sc_time_stamp ().to_seconds ()
+					      * 1e9)) != 0
+	  || fclose (f) != 0)
+	{
+	  fprintf (stderr, "ArchC: Unable to take a snapshot for the GDB "
+		   "history\n");
+	  free (state);
+	  return;
+	}
+
+      s = new snapshot;
+      s->instructions = instructions;
+      s->state = state;
+      s->state_size = size;
+      snapshots.push_back (s);
+      used += size;
+
+      // Pages written from now on belong to this one.
+      for (size_t i = 0; i < memories.size (); i++)
+	memories[i]->clean ();
+
+      // Take them closer again once there is room for it.
+      if (used < budget / 4 && interval > min_interval)
+	interval = std::max (interval / 2, min_interval);
+    }
+
+  trim (instructions);
+}
+
+// Fit the snapshots in the window and in the budget.
+void
+history::trim (uint64_t instructions)
+{
+  // Nothing older than the window is needed, but the snapshot it starts
+  // from.
+  while (snapshots.size () > 1
+	 && snapshots[1]->instructions + window <= instructions)
+    {
+      drop (snapshots[0]);
+      snapshots.erase (snapshots.begin ());
+    }
+
+  // Merge the closest snapshots, but never the newest, which is still
+  // collecting pages.
+  while (used > budget && snapshots.size () > 2)
+    {
+      size_t best = 1;
+      uint64_t gap, best_gap = UINT64_MAX;
+
+      for (size_t i = 1; i + 1 < snapshots.size (); i++)
+	{
+	  gap = snapshots[i + 1]->instructions - snapshots[i - 1]->instructions;
+	  if (gap < best_gap)
+	    {
+	      best = i;
+	      best_gap = gap;
+	    }
+	}
+      merge (best);
+
+      // New snapshots shouldn't be closer than the ones kept.
+      for (size_t i = 1; i < snapshots.size (); i++)
+	best_gap = std::min (best_gap, snapshots[i]->instructions
+			     - snapshots[i - 1]->instructions);
+      interval = std::max (interval, best_gap);
+    }
+
+  // Not even the last stretch fits.  Start over.
+  while (used > budget && !snapshots.empty ())
+    {
+      drop (snapshots[0]);
+      snapshots.erase (snapshots.begin ());
+      next = instructions;
+    }
+}
+
+// Fold snapshot I into the one before it.  Its pages are only needed
+// where the older one has none.
+void
+history::merge (size_t i)
+{
+  snapshot *older = snapshots[i - 1];
+  snapshot *s = snapshots[i];
+  std::map < uint64_t, unsigned char *>::iterator p;
+
+  for (p = s->pages.begin (); p != s->pages.end (); p++)
+    if (!older->pages.insert (*p).second)
+      {
+	delete[]p->second;
+	used -= PAGE_COST;
+      }
+  s->pages.clear ();
+
+  drop (s);
+  snapshots.erase (snapshots.begin () + i);
+}
+
+void
+history::drop (snapshot * s)
+{
+  std::map < uint64_t, unsigned char *>::iterator p;
+
+  for (p = s->pages.begin (); p != s->pages.end (); p++)
+    {
+      delete[]p->second;
+      used -= PAGE_COST;
+    }
+  free (s->state);
+  used -= s->state_size;
+  delete s;
+}
+
+bool
+history::rewind (uint64_t instructions)
+{
+  std::map < uint64_t, unsigned char *>::iterator p;
+  size_t k = snapshots.size ();
+  snapshot *s;
+
+  while (k > 0 && snapshots[k - 1]->instructions > instructions)
+    k--;
+  if (k == 0)
+    return false;
+  s = snapshots[--k];
+
+  // Devices must be done with the present before going to the past.
+  qkeeper->sync ();
+
+  // Newest first, so the oldest contents of each page win.
+  for (size_t j = snapshots.size (); j > k; j--)
+    for (p = snapshots[j - 1]->pages.begin ();
+	 p != snapshots[j - 1]->pages.end (); p++)
+      memcpy (memories[p->first >> 32]->page_data ((uint32_t) p->first),
+	      p->second, ram_module::PAGE_SIZE);
+
+  for (size_t j = k + 1; j < snapshots.size (); j++)
+    drop (snapshots[j]);
+  snapshots.resize (k + 1);
+
+  for (p = s->pages.begin (); p != s->pages.end (); p++)
+    {
+      delete[]p->second;
+      used -= PAGE_COST;
+    }
+  s->pages.clear ();
+  for (size_t i = 0; i < memories.size (); i++)
+    memories[i]->clean ();
+
+  if (platform.restore_state (s->state, s->state_size) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to go back in the GDB history\n");
+      exit (1);
+    }
+  next = s->instructions + interval;
+  return true;
+}
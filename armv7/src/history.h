@@ -0,0 +1,101 @@
+// 'history.h' - Execution history for reverse debugging
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "checkpoint.h"
+
+class ram_module;
+
+// Snapshots of the recent past, so GDB can run the guest backwards.  A
+// point in the past is reached by going back to the last snapshot
+// before it and running forward again, which ends in the same place as
+// long as the run doesn't depend on the host; console input doesn't,
+// since it is answered from the log kept by host_input.
+//
+// A snapshot is the state of every device but memories, taken through
+// the platform checkpoint, plus what each memory page held before its
+// first write since the snapshot.  So a snapshot costs what the guest
+// wrote in the meantime, and going back copies the pages written since
+// then back in place, newest snapshot first.
+//
+// Snapshots are taken every INTERVAL instructions and kept for the last
+// WINDOW instructions, in BUDGET bytes.  When they don't fit, the two
+// closest ones are merged and snapshots are taken further apart, so
+// they spread evenly over as much of the window as fits.
+class history
+{
+public:
+
+  history (checkpoint & platform, size_t budget, uint64_t window);
+  ~history ();
+
+  void add (ram_module * ram);
+
+  // Called between instructions, right after the core synchronized
+  // with the rest of the platform.
+  void poll (uint64_t instructions)
+  {
+    if (instructions < next && used <= budget)
+      return;
+    take (instructions);
+  }
+
+  // RAM is about to write PAGE for the first time since the last
+  // snapshot.
+  void page_written (ram_module * ram, uint32_t page);
+
+  // Go back to the last snapshot at or before INSTRUCTIONS.  Returns
+  // false if the history doesn't go that far back.
+  bool rewind (uint64_t instructions);
+
+private:
+
+  struct snapshot
+  {
+    uint64_t instructions;
+    char *state;
+    size_t state_size;
+
+    // Old page contents, by memory << 32 | page.
+    std::map < uint64_t, unsigned char *>pages;
+  };
+
+  checkpoint & platform;
+  std::vector < ram_module * >memories;
+  std::vector < snapshot * >snapshots;
+
+  size_t budget;
+  size_t used;
+  uint64_t window;
+  uint64_t min_interval;
+  uint64_t interval;
+  uint64_t next;
+
+  void take (uint64_t instructions);
+  void merge (size_t i);
+  void drop (snapshot * s);
+  void trim (uint64_t instructions);
+};
+
+#endif // !HISTORY_H.
@@ -0,0 +1,76 @@
+// 'host_profile.cpp' - Host time spent per simulator subsystem
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "host_profile.h"
+
+#ifdef HOST_PROFILE
+
+namespace host_prof
+{
+  frame stack[MAX_DEPTH];
+  int depth;
+  stat stats[N_SCOPES];
+
+  static const char *names[N_SCOPES] = {
+    "decode", "dispatch", "mmu", "bus", "systemc",
+    "tzic", "gpt", "uart", "esdhc", "sdcard"
+  };
+
+  static uint64_t start_ticks;
+  static struct timespec start_time;
+
+  void start ()
+  {
+    clock_gettime (CLOCK_MONOTONIC, &start_time);
+    start_ticks = now ();
+  }
+
+  void report (FILE * stream)
+  {
+    struct timespec end_time;
+    uint64_t ticks = now () - start_ticks;
+    uint64_t accounted = 0;
+    double wall, per_tick;
+
+    clock_gettime (CLOCK_MONOTONIC, &end_time);
+    wall = (end_time.tv_sec - start_time.tv_sec)
+      + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+    if (ticks == 0 || wall <= 0)
+      return;
+
+    // Calibrate the time stamp counter against the run itself.
+    per_tick = wall / ticks;
+
+    fprintf (stream, "ArchC: Host time breakdown, %.3f s wall\n", wall);
+    fprintf (stream, "ArchC: %-10s %12s %10s %10s %7s\n", "scope", "calls",
+	     "total (s)", "self (s)", "self %");
+    for (int i = 0; i < N_SCOPES; i++)
+      {
+	accounted += stats[i].self;
+	fprintf (stream, "ArchC: %-10s %12llu %10.3f %10.3f %6.2f%%\n",
+		 names[i], (unsigned long long) stats[i].calls,
+		 stats[i].total * per_tick, stats[i].self * per_tick,
+		 100.0 * stats[i].self / ticks);
+      }
+    if (accounted < ticks)
+      fprintf (stream, "ArchC: %-10s %12s %10s %10.3f %6.2f%%\n", "other", "",
+	       "", (ticks - accounted) * per_tick,
+	       100.0 * (ticks - accounted) / ticks);
+  }
+}
+
+#endif // HOST_PROFILE.
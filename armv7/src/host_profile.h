@@ -0,0 +1,153 @@
+// 'host_profile.h' - Host time spent per simulator subsystem
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HOST_PROFILE_H
+#define HOST_PROFILE_H
+
+// Built only with ./configure --enable-host-profile, which defines
+// HOST_PROFILE.  Otherwise, every macro below expands to nothing.
+//
+// Scopes nest on a single stack shared by all SystemC threads.  That
+// works because a thread never holds a scope across wait(): the core
+// waits inside HP_SYSTEMC, so device threads running meanwhile nest
+// under it, and device threads close their scope before waiting.  The
+// self time of HP_SYSTEMC is then the SystemC scheduler overhead.
+
+#ifdef HOST_PROFILE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+namespace host_prof
+{
+  enum scope_id
+  {
+    HP_DECODE,
+    HP_DISPATCH,
+    HP_MMU,
+    HP_BUS,
+    HP_SYSTEMC,
+    HP_TZIC,
+    HP_GPT,
+    HP_UART,
+    HP_ESDHC,
+    HP_SDCARD,
+    N_SCOPES
+  };
+
+  // Far deeper than the platform ever nests.
+  static const int MAX_DEPTH = 64;
+
+  struct frame
+  {
+    scope_id id;
+    uint64_t start;
+    uint64_t children;
+  };
+
+  struct stat
+  {
+    uint64_t calls;
+    uint64_t total;
+    uint64_t self;
+  };
+
+  extern frame stack[MAX_DEPTH];
+  extern int depth;
+  extern stat stats[N_SCOPES];
+
+  // Time stamp counter where there is one, nanoseconds otherwise.
+  inline uint64_t now ()
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    uint32_t lo, hi;
+    __asm__ __volatile__ ("rdtsc":"=a" (lo), "=d" (hi));
+    return ((uint64_t) hi << 32) | lo;
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+  }
+
+  inline void begin (scope_id id)
+  {
+    frame & f = stack[depth++];
+    f.id = id;
+    f.children = 0;
+    f.start = now ();
+  }
+
+  inline void end ()
+  {
+    frame & f = stack[--depth];
+    uint64_t elapsed = now () - f.start;
+
+    stats[f.id].calls++;
+    stats[f.id].total += elapsed;
+    stats[f.id].self += elapsed - f.children;
+    if (depth > 0)
+      stack[depth - 1].children += elapsed;
+  }
+
+  // Close scopes skipped by a longjmp, like ac_annul does.
+  inline void unwind ()
+  {
+    while (depth > 0)
+      end ();
+  }
+
+  class scope
+  {
+  public:
+    scope (scope_id id)
+    {
+      begin (id);
+    }
+
+     ~scope ()
+    {
+      end ();
+    }
+  };
+
+  // Mark the start of the measured run.
+  void start ();
+
+  void report (FILE * stream);
+}
+
+#define HOST_PROFILE_SCOPE(id) host_prof::scope host_prof_scope (host_prof::id)
+#define HOST_PROFILE_BEGIN(id) host_prof::begin (host_prof::id)
+#define HOST_PROFILE_END() host_prof::end ()
+#define HOST_PROFILE_UNWIND() host_prof::unwind ()
+#define HOST_PROFILE_START() host_prof::start ()
+#define HOST_PROFILE_REPORT(stream) host_prof::report (stream)
+
+#else // !HOST_PROFILE.
+
+#define HOST_PROFILE_SCOPE(id)
+#define HOST_PROFILE_BEGIN(id)
+#define HOST_PROFILE_END()
+#define HOST_PROFILE_UNWIND()
+#define HOST_PROFILE_START()
+#define HOST_PROFILE_REPORT(stream)
+
+#endif // HOST_PROFILE.
+
+#endif // !HOST_PROFILE_H.
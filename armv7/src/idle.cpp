@@ -0,0 +1,128 @@
+// 'idle.cpp' - Idle detection and time fast-forward for the ARM core
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "idle.h"
+#include "quantum.h"
+#include "host_profile.h"
+
+extern bool DEBUG_CORE;
+extern quantum_keeper *qkeeper;
+#define dprintf(args...) if(DEBUG_CORE){fprintf(stderr,args);}
+
+idle_detector::idle_detector ():
+enabled (false), max_skip (100000), woken (false), loop_signature (0),
+signature (0), stored (false), skipped_ns (0), wfi_count (0), loop_count (0)
+{
+  reset_loop ();
+}
+
+void
+idle_detector::branch (uint32_t pc, uint32_t target, const uint32_t * state)
+{
+  // Branch to self: only an exception gets us out of here.
+  if (pc == target)
+    {
+      loop_count++;
+      sleep (true);
+      return;
+    }
+
+  if (pc == loop_pc && target == loop_target && !stored
+      && signature == loop_signature
+      && memcmp (state, loop_state, sizeof (loop_state)) == 0)
+    matches++;
+  else
+    matches = 0;
+
+  loop_pc = pc;
+  loop_target = target;
+  loop_signature = signature;
+  memcpy (loop_state, state, sizeof (loop_state));
+  signature = 0;
+  stored = false;
+
+  // The last two iterations were identical, and so will be the next
+  // ones until something outside the core changes.
+  if (matches >= 1)
+    {
+      loop_count++;
+      sleep (false);
+    }
+}
+
+void
+idle_detector::wfi ()
+{
+  if (!enabled)
+    return;
+
+  wfi_count++;
+  sleep (true);
+}
+
+// Let simulated time run until the next device event, an exception or
+// MAX_SKIP, whichever comes first.  If the core waits for an interrupt,
+// device events are of no interest.
+void
+idle_detector::sleep (bool until_interrupt)
+{
+  uint64_t delay = max_skip;
+
+  // Device events are relative to the kernel time.  An exception
+  // taken while catching up means we are not idle anymore.
+  woken = false;
+  qkeeper->sync ();
+  if (woken)
+    {
+      reset_loop ();
+      return;
+    }
+
+  if (!until_interrupt)
+    for (size_t i = 0; i < sources.size (); i++)
+      {
+	uint64_t next = sources[i]->next_event_ns ();
+	if (next < delay)
+	  delay = next;
+      }
+
+  reset_loop ();
+
+  // Not worth it: the core would be back before it left.
+  if (delay <= 1)
+    return;
+
+  dprintf ("Core idle for up to %llu ns\n", (unsigned long long) delay);
+
+  sc_time start = sc_time_stamp ();
+  {
+    HOST_PROFILE_SCOPE (HP_SYSTEMC);
+    wait (sc_time ((double) delay, SC_NS), wakeup);
+  }
+  skipped_ns += (uint64_t) ((sc_time_stamp () - start).to_seconds () * 1e9);
+}
+
+void
+idle_detector::print_stats (FILE * stream) const
+{
+  if (!enabled)
+    return;
+
+  fprintf (stream, "ArchC: Idle: %llu ns skipped (%llu WFI, %llu idle loops)\n",
+	   (unsigned long long) skipped_ns, (unsigned long long) wfi_count,
+	   (unsigned long long) loop_count);
+}
@@ -0,0 +1,132 @@
+// 'idle.h' - Idle detection and time fast-forward for the ARM core
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <systemc.h>
+#include <vector>
+
+// Devices whose state may change on their own, without the core doing
+// anything, implement this interface so an idle core knows how far
+// ahead it can jump.
+class idle_source
+{
+public:
+  static const uint64_t NO_EVENT = ~0ULL;
+
+  virtual ~idle_source ()
+  {
+  }
+
+  // Nanoseconds until this device may change something the core can
+  // observe, or NO_EVENT if it will not change on its own.
+  virtual uint64_t next_event_ns () = 0;
+};
+
+// The core is idle when it runs WFI, branches to itself, or goes around
+// a short loop twice with the same registers, reading the same values
+// from the bus and writing nothing.  In any of those cases, nothing but
+// an interrupt or a device state change can make it progress, so we
+// stop interpreting instructions and let simulated time run until the
+// next device event.
+class idle_detector
+{
+public:
+
+  // Longest loop body considered, in bytes.
+  static const uint32_t MAX_LOOP_SIZE = 64;
+
+  // Number of registers in the state snapshot: r0-r14 and CPSR.
+  static const int STATE_SIZE = 16;
+
+  idle_detector ();
+
+  bool enabled;
+
+  // Upper bound for a single skip, in nanoseconds.
+  uint64_t max_skip;
+
+  void add_source (idle_source * source)
+  {
+    sources.push_back (source);
+  }
+
+  // Whether a taken branch from PC to TARGET may close an idle loop.
+  bool loop_candidate (uint32_t pc, uint32_t target) const
+  {
+    return enabled && target <= pc && pc - target <= MAX_LOOP_SIZE;
+  }
+
+  // A taken branch from PC to TARGET, with the core registers in STATE.
+  void branch (uint32_t pc, uint32_t target, const uint32_t * state);
+
+  // The core executed a wait for interrupt.
+  void wfi ();
+
+  // Bus activity of the core.
+  void bus_read (uint32_t addr, uint32_t data)
+  {
+    signature = (signature * 31 + addr) * 31 + data;
+  }
+
+  void bus_write ()
+  {
+    stored = true;
+  }
+
+  // An exception was signaled to the core.
+  void interrupt ()
+  {
+    woken = true;
+    wakeup.notify ();
+  }
+
+  void print_stats (FILE * stream) const;
+
+private:
+
+  sc_event wakeup;
+  bool woken;
+  std::vector < idle_source * >sources;
+
+  // Loop being tracked and its last iteration.
+  uint32_t loop_pc, loop_target;
+  uint32_t loop_state[STATE_SIZE];
+  uint32_t loop_signature;
+  unsigned matches;
+
+  // Bus activity since the last branch.
+  uint32_t signature;
+  bool stored;
+
+  uint64_t skipped_ns;
+  uint64_t wfi_count, loop_count;
+
+  void reset_loop ()
+  {
+    loop_pc = loop_target = 0;
+    matches = 0;
+  }
+
+  void sleep (bool until_interrupt);
+};
+
+#endif // !IDLE_H.
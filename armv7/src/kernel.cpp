@@ -0,0 +1,281 @@
+// 'kernel.cpp' - Direct kernel boot
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "kernel.h"
+#include "ram.h"
+
+#include <elf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ATAG list entries, from the Linux ARM boot protocol.  Each one starts
+// with its size in words, header included, and its tag.
+static const uint32_t ATAG_NONE = 0x00000000;
+static const uint32_t ATAG_CORE = 0x54410001;
+static const uint32_t ATAG_MEM = 0x54410002;
+static const uint32_t ATAG_CMDLINE = 0x54410009;
+
+static const uint32_t PAGE_SIZE = 4096;
+
+// Big-endian, at the start of every flattened device tree.
+static const unsigned char FDT_MAGIC[4] = { 0xd0, 0x0d, 0xfe, 0xed };
+
+kernel_loader::kernel_loader ():entry_point (0)
+{
+}
+
+void
+kernel_loader::add_memory (ram_module * ram, uint32_t base)
+{
+  memory m;
+
+  m.ram = ram;
+  m.base = base;
+  m.size = ram->size ();
+  memories.push_back (m);
+}
+
+// The memory holding all of [ADDRESS, ADDRESS + SIZE), if any.
+const kernel_loader::memory *
+kernel_loader::find (uint64_t address, uint64_t size) const
+{
+  for (size_t i = 0; i < memories.size (); i++)
+    if (address >= memories[i].base
+	&& address + size <= (uint64_t) memories[i].base + memories[i].size)
+      return &memories[i];
+  return NULL;
+}
+
+// Copy SIZE bytes of DATA, or zeros if it is NULL, to physical ADDRESS.
+int
+kernel_loader::copy (const char *what, uint32_t address, const void *data,
+		     uint32_t size)
+{
+  const memory *m = find (address, size);
+  uint64_t end = (uint64_t) address + size;
+
+  if (size == 0)
+    return 0;
+
+  if (m == NULL)
+    {
+      fprintf (stderr, "ArchC: The %s does not fit in RAM at 0x%08X\n",
+	       what, address);
+      return -1;
+    }
+
+  for (size_t i = 0; i < used.size (); i++)
+    if (address < used[i].second && end > used[i].first)
+      {
+	fprintf (stderr, "ArchC: The %s at 0x%08X overlaps what was loaded "
+		 "at 0x%08X\n", what, address, (uint32_t) used[i].first);
+	return -1;
+      }
+
+  m->ram->write_block (address - m->base, data, size);
+  used.push_back (std::make_pair ((uint64_t) address, end));
+  return 0;
+}
+
+int
+kernel_loader::load_elf (const char *file)
+{
+  const unsigned char *image;
+  const Elf32_Ehdr *ehdr;
+  const Elf32_Phdr *phdr;
+  struct stat st;
+  bool has_entry = false;
+  void *map;
+  int fd, ret = 0;
+
+  fd = open (file, O_RDONLY);
+  if (fd < 0 || fstat (fd, &st) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      if (fd >= 0)
+	close (fd);
+      return -1;
+    }
+
+  // Debug info makes up most of a vmlinux, and is never looked at.
+  map = st.st_size > 0
+    ? mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      fprintf (stderr, "ArchC: Unable to map %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  image = (const unsigned char *) map;
+  ehdr = (const Elf32_Ehdr *) image;
+  if ((size_t) st.st_size < sizeof (Elf32_Ehdr)
+      || memcmp (ehdr->e_ident, ELFMAG, SELFMAG) != 0
+      || ehdr->e_ident[EI_CLASS] != ELFCLASS32
+      || ehdr->e_ident[EI_DATA] != ELFDATA2LSB
+      || ehdr->e_machine != EM_ARM
+      || ehdr->e_phoff + (uint64_t) ehdr->e_phnum * sizeof (Elf32_Phdr)
+      > (uint64_t) st.st_size)
+    {
+      fprintf (stderr, "ArchC: %s is not a 32-bit little-endian ARM ELF\n",
+	       file);
+      munmap (map, st.st_size);
+      return -1;
+    }
+
+  phdr = (const Elf32_Phdr *) (image + ehdr->e_phoff);
+  for (int i = 0; i < ehdr->e_phnum && ret == 0; i++)
+    {
+      uint64_t address = phdr[i].p_paddr;
+
+      if (phdr[i].p_type != PT_LOAD || phdr[i].p_memsz == 0)
+	continue;
+
+      if (phdr[i].p_filesz > phdr[i].p_memsz
+	  || phdr[i].p_offset + (uint64_t) phdr[i].p_filesz
+	  > (uint64_t) st.st_size)
+	{
+	  fprintf (stderr, "ArchC: %s is truncated\n", file);
+	  ret = -1;
+	  break;
+	}
+
+      if (find (address, phdr[i].p_memsz) == NULL && !memories.empty ())
+	address += memories[0].base;
+      if (address > 0xFFFFFFFFULL)
+	address = phdr[i].p_paddr;
+      if (address + phdr[i].p_memsz > 0x100000000ULL)
+	{
+	  fprintf (stderr, "ArchC: Segment %d of %s does not fit below 4GiB "
+		   "at 0x%08llX\n", i, file, (unsigned long long) address);
+	  ret = -1;
+	  break;
+	}
+
+      // The rest of the segment is its .bss.
+      ret = copy ("kernel", address, image + phdr[i].p_offset,
+		  phdr[i].p_filesz);
+      if (ret == 0)
+	ret = copy ("kernel", address + phdr[i].p_filesz, NULL,
+		    phdr[i].p_memsz - phdr[i].p_filesz);
+
+      // The entry point is a virtual address.
+      if (ehdr->e_entry >= phdr[i].p_vaddr
+	  && ehdr->e_entry - phdr[i].p_vaddr < phdr[i].p_memsz)
+	{
+	  entry_point = address + (ehdr->e_entry - phdr[i].p_vaddr);
+	  has_entry = true;
+	}
+    }
+
+  munmap (map, st.st_size);
+  if (ret != 0)
+    return -1;
+
+  if (!has_entry)
+    {
+      fprintf (stderr, "ArchC: The entry point of %s is not in any of its "
+	       "segments\n", file);
+      return -1;
+    }
+
+  fprintf (stderr, "ArchC: Loaded kernel %s, entry point at 0x%08X\n",
+	   file, entry_point);
+  return 0;
+}
+
+int
+kernel_loader::load_dtb (const char *file, uint32_t address)
+{
+  FILE *f = fopen (file, "rb");
+  std::vector < unsigned char >data;
+  long size;
+
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  fseek (f, 0, SEEK_END);
+  size = ftell (f);
+  fseek (f, 0, SEEK_SET);
+
+  data.resize (size > 0 ? size : 1);
+  if (size < (long) sizeof (FDT_MAGIC)
+      || fread (&data[0], 1, size, f) != (size_t) size
+      || memcmp (&data[0], FDT_MAGIC, sizeof (FDT_MAGIC)) != 0)
+    {
+      fprintf (stderr, "ArchC: %s is not a flattened device tree\n", file);
+      fclose (f);
+      return -1;
+    }
+  fclose (f);
+
+  if (copy ("device tree", address, &data[0], size) != 0)
+    return -1;
+
+  fprintf (stderr, "ArchC: Loaded device tree %s at 0x%08X\n", file,
+	   address);
+  return 0;
+}
+
+int
+kernel_loader::write_atags (uint32_t address, const char *cmdline)
+{
+  std::vector < uint32_t > tags;
+
+  // Read-only root, since nothing is known about it.
+  tags.push_back (5);
+  tags.push_back (ATAG_CORE);
+  tags.push_back (1);
+  tags.push_back (PAGE_SIZE);
+  tags.push_back (0);
+
+  for (size_t i = 0; i < memories.size (); i++)
+    {
+      tags.push_back (4);
+      tags.push_back (ATAG_MEM);
+      tags.push_back (memories[i].size);
+      tags.push_back (memories[i].base);
+    }
+
+  if (cmdline != NULL)
+    {
+      size_t words = (strlen (cmdline) + 1 + 3) / 4;
+      size_t start = tags.size () + 2;
+
+      tags.push_back (2 + words);
+      tags.push_back (ATAG_CMDLINE);
+      tags.resize (start + words, 0);
+      memcpy (&tags[start], cmdline, strlen (cmdline));
+    }
+
+  tags.push_back (0);
+  tags.push_back (ATAG_NONE);
+
+  return copy ("ATAG list", address, &tags[0],
+	       tags.size () * sizeof (uint32_t));
+}
@@ -0,0 +1,80 @@
+// 'kernel.h' - Direct kernel boot
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class ram_module;
+
+// Leaves a kernel in memory the way a boot loader would, so the core
+// can start right at its entry point instead of going through the boot
+// ROM and the SD card.
+class kernel_loader
+{
+public:
+
+  kernel_loader ();
+
+  // RAM the kernel and its boot data can go to, mapped at BASE.  The
+  // first one added is where physical addresses start.
+  void add_memory (ram_module * ram, uint32_t base);
+
+  // Load the PT_LOAD segments of ELF FILE, at their physical address.
+  // Kernels linked with physical addresses relative to the start of RAM
+  // (vmlinux has them at 0x8000) are loaded that far into the first
+  // memory.  All return 0 on success and -1 on failure.
+  int load_elf (const char *file);
+
+  // Copy the flattened device tree in FILE to ADDRESS.
+  int load_dtb (const char *file, uint32_t address);
+
+  // Write an ATAG list to ADDRESS, describing the memories and, if
+  // CMDLINE is not NULL, the kernel command line.
+  int write_atags (uint32_t address, const char *cmdline);
+
+  // Physical address of the entry point of the loaded ELF.
+  uint32_t entry () const
+  {
+    return entry_point;
+  }
+
+private:
+
+  struct memory
+  {
+    ram_module *ram;
+    uint32_t base;
+    uint32_t size;
+  };
+
+  std::vector < memory > memories;
+
+  // What was loaded so far, [start, end), so nothing goes on top of it.
+  std::vector < std::pair < uint64_t, uint64_t > >used;
+
+  uint32_t entry_point;
+
+  const memory *find (uint64_t address, uint64_t size) const;
+  int copy (const char *what, uint32_t address, const void *data,
+	    uint32_t size);
+};
+
+#endif // !KERNEL_H.
@@ -0,0 +1,185 @@
+// 'latency.cpp' - Interrupt latency histograms
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "latency.h"
+#include "quantum.h"
+
+#include <string.h>
+
+extern quantum_keeper *qkeeper;
+
+// Width of the widest histogram bar.
+static const unsigned BAR_WIDTH = 40;
+
+histogram::histogram ():
+count (0), sum (0), min (~0ULL), max (0)
+{
+  memset (buckets, 0, sizeof (buckets));
+}
+
+void
+histogram::add (uint64_t value)
+{
+  unsigned b = 0;
+
+  while (b + 1 < N_BUCKETS && (value >> (b + 1)))
+    b++;
+
+  buckets[b]++;
+  count++;
+  sum += value;
+  if (value < min)
+    min = value;
+  if (value > max)
+    max = value;
+}
+
+void
+histogram::print (FILE * stream, const char *what, const char *unit) const
+{
+  uint64_t peak = 0;
+  unsigned first = N_BUCKETS, last = 0;
+
+  if (count == 0)
+    return;
+
+  for (unsigned i = 0; i < N_BUCKETS; i++)
+    if (buckets[i])
+      {
+	if (first == N_BUCKETS)
+	  first = i;
+	last = i;
+	if (buckets[i] > peak)
+	  peak = buckets[i];
+      }
+
+  fprintf (stream, "ArchC:   %s (%s): min %llu, avg %.1f, max %llu\n", what,
+	   unit, (unsigned long long) min, (double) sum / count,
+	   (unsigned long long) max);
+
+  for (unsigned i = first; i <= last; i++)
+    {
+      unsigned width = buckets[i] * BAR_WIDTH / peak;
+      char bar[BAR_WIDTH + 1];
+
+      memset (bar, '#', width);
+      bar[width] = '\0';
+      fprintf (stream, "ArchC:     [%12llu, %12llu) %10llu %5.1f%% %s\n",
+	       i ? 1ULL << i : 0ULL,
+	       i + 1 < N_BUCKETS ? 1ULL << (i + 1) : ~0ULL,
+	       (unsigned long long) buckets[i], 100.0 * buckets[i] / count,
+	       bar);
+    }
+}
+
+irq_latency::irq_latency (const unsigned long long *instructions_):
+instructions (instructions_), spurious (0)
+{
+  memset (pending, 0, sizeof (pending));
+  memset (asserted_at, 0, sizeof (asserted_at));
+}
+
+irq_latency::stamp irq_latency::now () const
+{
+  stamp s;
+
+  // Devices run while the core is synchronized, so this is right from
+  // any thread.
+  s.ns = (uint64_t) (qkeeper->get_current_time ().to_seconds () * 1e9);
+  s.instructions = *instructions;
+  return s;
+}
+
+void
+irq_latency::line (unsigned n, bool asserted)
+{
+  if (n >= N_LINES)
+    return;
+
+  // Lines dropped before delivery were never seen by the core.
+  pending[n] = asserted;
+  if (asserted)
+    asserted_at[n] = now ();
+}
+
+void
+irq_latency::enter (uint32_t cpsr)
+{
+  frame f;
+
+  f.at = now ();
+  f.cpsr = cpsr;
+
+  for (unsigned n = 0; n < N_LINES; n++)
+    {
+      if (!pending[n])
+	continue;
+
+      line_stats & s = stats[n];
+      s.latency_ns.add (f.at.ns - asserted_at[n].ns);
+      s.latency_instructions.add (f.at.instructions
+				  - asserted_at[n].instructions);
+      pending[n] = false;
+      f.lines.push_back (n);
+    }
+
+  if (f.lines.empty ())
+    spurious++;
+
+  if (handlers.size () == MAX_NESTING)
+    handlers.erase (handlers.begin ());
+  handlers.push_back (f);
+}
+
+void
+irq_latency::restore (uint32_t spsr)
+{
+  stamp t;
+
+  if (handlers.empty () || handlers.back ().cpsr != spsr)
+    return;
+
+  t = now ();
+  frame & f = handlers.back ();
+  for (size_t i = 0; i < f.lines.size (); i++)
+    {
+      line_stats & s = stats[f.lines[i]];
+      s.handler_ns.add (t.ns - f.at.ns);
+      s.handler_instructions.add (t.instructions - f.at.instructions);
+    }
+  handlers.pop_back ();
+}
+
+void
+irq_latency::print_stats (FILE * stream) const
+{
+  for (std::map < unsigned, line_stats >::const_iterator it = stats.begin ();
+       it != stats.end (); ++it)
+    {
+      fprintf (stream, "ArchC: IRQ %u\n", it->first);
+      it->second.latency_ns.print (stream, "latency", "ns");
+      it->second.latency_instructions.print (stream, "latency",
+					     "instructions");
+      it->second.handler_ns.print (stream, "handler", "ns");
+      it->second.handler_instructions.print (stream, "handler",
+					     "instructions");
+    }
+
+  if (spurious)
+    fprintf (stream, "ArchC: %llu IRQ entries with no line pending\n",
+	     (unsigned long long) spurious);
+}
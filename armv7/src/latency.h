@@ -0,0 +1,117 @@
+// 'latency.h' - Interrupt latency histograms
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+// Power of two buckets: bucket N counts values in [2^N, 2^(N+1)), and
+// bucket 0 counts zeros too.
+class histogram
+{
+public:
+
+  static const unsigned N_BUCKETS = 64;
+
+  histogram ();
+
+  void add (uint64_t value);
+
+  void print (FILE * stream, const char *what, const char *unit) const;
+
+private:
+
+  uint64_t buckets[N_BUCKETS];
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+};
+
+// Latency from a TZIC line assertion to the core entering the IRQ
+// vector, and handler duration from there to the SPSR restore that
+// goes back to the interrupted context, per interrupt line, in
+// simulated nanoseconds and in instructions.
+//
+// An entry is charged to every line driving the IRQ and not yet
+// delivered.  A handler ends when the restored CPSR is the one it
+// interrupted, so handlers that switch modes on the way, as Linux
+// does, are measured until they really return.
+class irq_latency
+{
+public:
+
+  static const unsigned N_LINES = 128;
+
+  // Handlers nested deeper are dropped.
+  static const unsigned MAX_NESTING = 16;
+
+  // INSTRUCTIONS is the core instruction counter.
+  irq_latency (const unsigned long long *instructions);
+
+  // TZIC line N started or stopped driving the core's IRQ: it is
+  // asserted, enabled and above the priority mask, or no longer.
+  void line (unsigned n, bool asserted);
+
+  // The core takes an IRQ while running with CPSR.
+  void enter (uint32_t cpsr);
+
+  // The core copies SPSR back to CPSR.
+  void restore (uint32_t spsr);
+
+  void print_stats (FILE * stream) const;
+
+private:
+
+  struct stamp
+  {
+    uint64_t ns;
+    uint64_t instructions;
+  };
+
+  struct frame
+  {
+    stamp at;
+    uint32_t cpsr;
+    std::vector < unsigned >lines;
+  };
+
+  struct line_stats
+  {
+    histogram latency_ns;
+    histogram latency_instructions;
+    histogram handler_ns;
+    histogram handler_instructions;
+  };
+
+  const unsigned long long *instructions;
+
+  bool pending[N_LINES];
+  stamp asserted_at[N_LINES];
+
+  std::vector < frame > handlers;
+  std::map < unsigned, line_stats > stats;
+  uint64_t spurious;
+
+  stamp now () const;
+};
+
+#endif // !LATENCY_H.
@@ -0,0 +1,541 @@
+// 'lines.cpp' - Source line information of guest programs
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "lines.h"
+
+#include <elf.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+// DWARF constants used by the line number program.
+enum
+{
+  DW_LNS_copy = 1,
+  DW_LNS_advance_pc = 2,
+  DW_LNS_advance_line = 3,
+  DW_LNS_set_file = 4,
+  DW_LNS_const_add_pc = 8,
+  DW_LNS_fixed_advance_pc = 9,
+
+  DW_LNE_end_sequence = 1,
+  DW_LNE_set_address = 2,
+  DW_LNE_define_file = 3,
+
+  DW_LNCT_path = 1,
+  DW_LNCT_directory_index = 2,
+
+  DW_FORM_data2 = 0x05,
+  DW_FORM_data4 = 0x06,
+  DW_FORM_data8 = 0x07,
+  DW_FORM_string = 0x08,
+  DW_FORM_block = 0x09,
+  DW_FORM_data1 = 0x0b,
+  DW_FORM_strp = 0x0e,
+  DW_FORM_udata = 0x0f,
+  DW_FORM_data16 = 0x1e,
+  DW_FORM_line_strp = 0x1f
+};
+
+// Bounds checked reader over a section.
+struct reader
+{
+  const unsigned char *p;
+  const unsigned char *end;
+  bool error;
+
+  reader (const unsigned char *start, const unsigned char *end_):
+  p (start), end (end_), error (false)
+  {
+  }
+
+  bool need (size_t n)
+  {
+    if (error || (size_t) (end - p) < n)
+      {
+	error = true;
+	p = end;
+	return false;
+      }
+    return true;
+  }
+
+  uint32_t u (unsigned n)
+  {
+    uint32_t v = 0;
+
+    if (!need (n))
+      return 0;
+    for (unsigned i = 0; i < n && i < 4; i++)
+      v |= (uint32_t) p[i] << (8 * i);
+    p += n;
+    return v;
+  }
+
+  uint64_t uleb ()
+  {
+    uint64_t v = 0;
+    unsigned shift = 0;
+
+    while (need (1))
+      {
+	unsigned char b = *p++;
+
+	if (shift < 64)
+	  v |= (uint64_t) (b & 0x7f) << shift;
+	shift += 7;
+	if (!(b & 0x80))
+	  break;
+      }
+    return v;
+  }
+
+  int64_t sleb ()
+  {
+    int64_t v = 0;
+    unsigned shift = 0;
+    unsigned char b = 0;
+
+    while (need (1))
+      {
+	b = *p++;
+	if (shift < 64)
+	  v |= (int64_t) (b & 0x7f) << shift;
+	shift += 7;
+	if (!(b & 0x80))
+	  break;
+      }
+    if (shift < 64 && (b & 0x40))
+      v |= -((int64_t) 1 << shift);
+    return v;
+  }
+
+  const char *str ()
+  {
+    const char *s = (const char *) p;
+    const unsigned char *nul = (const unsigned char *) memchr (p, 0, end - p);
+
+    if (nul == NULL)
+      {
+	error = true;
+	p = end;
+	return "";
+      }
+    p = nul + 1;
+    return s;
+  }
+
+  void skip (size_t n)
+  {
+    if (need (n))
+      p += n;
+  }
+};
+
+// String at OFFSET of a string section.
+static const char *
+section_string (const unsigned char *sec, size_t size, uint32_t offset)
+{
+  if (sec == NULL || offset >= size
+      || memchr (sec + offset, 0, size - offset) == NULL)
+    return "";
+  return (const char *) sec + offset;
+}
+
+static std::string
+join (const std::string & dir, const std::string & name)
+{
+  if (dir.empty () || name.empty () || name[0] == '/')
+    return name;
+  return dir + "/" + name;
+}
+
+unsigned
+line_table::file_id (const std::string & name)
+{
+  std::map < std::string, unsigned >::iterator it = file_ids.find (name);
+
+  if (it != file_ids.end ())
+    return it->second;
+
+  files.push_back (name);
+  file_ids[name] = files.size () - 1;
+  return files.size () - 1;
+}
+
+int
+line_table::load (const char *file)
+{
+  FILE *f = fopen (file, "rb");
+  const unsigned char *line = NULL, *line_str = NULL, *str = NULL;
+  size_t line_size = 0, line_str_size = 0, str_size = 0;
+  size_t before = ranges.size ();
+  unsigned char *image;
+  Elf32_Ehdr *ehdr;
+  Elf32_Shdr *shdr;
+  const char *names;
+  long size;
+  int ret;
+
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  fseek (f, 0, SEEK_END);
+  size = ftell (f);
+  fseek (f, 0, SEEK_SET);
+
+  image = (unsigned char *) malloc (size);
+  if (size < (long) sizeof (Elf32_Ehdr)
+      || fread (image, 1, size, f) != (size_t) size)
+    {
+      fprintf (stderr, "ArchC: Unable to read %s\n", file);
+      free (image);
+      fclose (f);
+      return -1;
+    }
+  fclose (f);
+
+  ehdr = (Elf32_Ehdr *) image;
+  if (memcmp (ehdr->e_ident, ELFMAG, SELFMAG) != 0
+      || ehdr->e_ident[EI_CLASS] != ELFCLASS32
+      || ehdr->e_ident[EI_DATA] != ELFDATA2LSB
+      || ehdr->e_shoff + (uint64_t) ehdr->e_shnum * sizeof (Elf32_Shdr)
+      > (uint64_t) size || ehdr->e_shstrndx >= ehdr->e_shnum)
+    {
+      fprintf (stderr, "ArchC: %s is not a 32-bit little-endian ELF\n",
+	       file);
+      free (image);
+      return -1;
+    }
+
+  shdr = (Elf32_Shdr *) (image + ehdr->e_shoff);
+  names = (const char *) image + shdr[ehdr->e_shstrndx].sh_offset;
+  for (int i = 0; i < ehdr->e_shnum; i++)
+    {
+      const char *name = names + shdr[i].sh_name;
+      const unsigned char *data = image + shdr[i].sh_offset;
+
+      if (shdr[i].sh_type == SHT_NOBITS
+	  || shdr[i].sh_offset + (uint64_t) shdr[i].sh_size > (uint64_t) size)
+	continue;
+
+      if (strcmp (name, ".debug_line") == 0)
+	{
+	  line = data;
+	  line_size = shdr[i].sh_size;
+	}
+      else if (strcmp (name, ".debug_line_str") == 0)
+	{
+	  line_str = data;
+	  line_str_size = shdr[i].sh_size;
+	}
+      else if (strcmp (name, ".debug_str") == 0)
+	{
+	  str = data;
+	  str_size = shdr[i].sh_size;
+	}
+    }
+
+  if (line == NULL)
+    {
+      fprintf (stderr, "ArchC: %s has no line information\n", file);
+      free (image);
+      return 0;
+    }
+
+  ret = parse (line, line_size, line_str, line_str_size, str, str_size);
+  free (image);
+  sorted = false;
+
+  if (ret != 0)
+    fprintf (stderr, "ArchC: Bad line information in %s\n", file);
+  else
+    fprintf (stderr, "ArchC: Loaded %u line ranges from %s\n",
+	     (unsigned) (ranges.size () - before), file);
+  return ret;
+}
+
+// Run the line number programs of all units in .debug_line.
+int
+line_table::parse (const unsigned char *data, size_t size,
+		   const unsigned char *line_str, size_t line_str_size,
+		   const unsigned char *str, size_t str_size)
+{
+  reader unit (data, data + size);
+
+  while (unit.p < unit.end && !unit.error)
+    {
+      uint32_t length = unit.u (4);
+      const unsigned char *unit_end;
+
+      // 64-bit DWARF is never used for 32-bit targets.
+      if (unit.error || length == 0xffffffff
+	  || length > (size_t) (unit.end - unit.p))
+	return -1;
+      unit_end = unit.p + length;
+
+      reader r (unit.p, unit_end);
+      unsigned version = r.u (2);
+      std::vector < std::string > dirs;
+      std::vector < unsigned > file_map;
+      const unsigned char *program;
+      unsigned min_inst, line_range, opcode_base;
+      int line_base;
+      std::vector < unsigned char >std_lengths;
+
+      unit.p = unit_end;
+      if (version < 2 || version > 5)
+	continue;
+
+      if (version >= 5)
+	r.skip (2);		// Address and segment selector sizes.
+      program = r.p + 4;
+      program += r.u (4);
+      min_inst = r.u (1);
+      if (version >= 4)
+	r.skip (1);		// Maximum operations per instruction.
+      r.skip (1);		// Default is_stmt.
+      line_base = (int8_t) r.u (1);
+      line_range = r.u (1);
+      opcode_base = r.u (1);
+      for (unsigned i = 1; i < opcode_base; i++)
+	std_lengths.push_back (r.u (1));
+      if (r.error || line_range == 0 || program > unit_end)
+	return -1;
+
+      if (version < 5)
+	{
+	  // Directory 0 is the compilation directory, which is not
+	  // listed; leave those names relative.
+	  dirs.push_back ("");
+	  for (const char *d = r.str (); *d && !r.error; d = r.str ())
+	    dirs.push_back (d);
+
+	  // Files are numbered from 1.
+	  file_map.push_back (file_id ("<unknown>"));
+	  for (const char *n = r.str (); *n && !r.error; n = r.str ())
+	    {
+	      uint64_t dir = r.uleb ();
+
+	      r.uleb ();	// Modification time.
+	      r.uleb ();	// Length.
+	      file_map.push_back (file_id (join (dir < dirs.size ()
+						 ? dirs[dir] : "", n)));
+	    }
+	}
+      else
+	{
+	  // Directory and file tables describe their own entry format.
+	  for (int table = 0; table < 2 && !r.error; table++)
+	    {
+	      std::vector < std::pair < uint64_t, uint64_t > >format;
+	      unsigned n_formats = r.u (1);
+	      uint64_t count;
+
+	      for (unsigned i = 0; i < n_formats && !r.error; i++)
+		{
+		  uint64_t type = r.uleb ();
+		  format.push_back (std::make_pair (type, r.uleb ()));
+		}
+
+	      count = r.uleb ();
+	      for (uint64_t e = 0; e < count && !r.error; e++)
+		{
+		  std::string path;
+		  uint64_t dir = 0;
+
+		  for (size_t i = 0; i < format.size (); i++)
+		    {
+		      uint64_t value = 0;
+		      const char *s = NULL;
+
+		      switch (format[i].second)
+			{
+			case DW_FORM_string:
+			  s = r.str ();
+			  break;
+			case DW_FORM_line_strp:
+			  s = section_string (line_str, line_str_size, r.u (4));
+			  break;
+			case DW_FORM_strp:
+			  s = section_string (str, str_size, r.u (4));
+			  break;
+			case DW_FORM_udata:
+			  value = r.uleb ();
+			  break;
+			case DW_FORM_data1:
+			  value = r.u (1);
+			  break;
+			case DW_FORM_data2:
+			  value = r.u (2);
+			  break;
+			case DW_FORM_data4:
+			  value = r.u (4);
+			  break;
+			case DW_FORM_data8:
+			  r.skip (8);
+			  break;
+			case DW_FORM_data16:
+			  r.skip (16);
+			  break;
+			case DW_FORM_block:
+			  r.skip (r.uleb ());
+			  break;
+			default:
+			  return -1;
+			}
+
+		      if (format[i].first == DW_LNCT_path && s)
+			path = s;
+		      else if (format[i].first == DW_LNCT_directory_index)
+			dir = value;
+		    }
+
+		  if (table == 0)
+		    dirs.push_back (path);
+		  else
+		    file_map.push_back (file_id (join (dir < dirs.size ()
+						       ? dirs[dir] : "",
+						       path)));
+		}
+	    }
+	}
+      if (r.error)
+	return -1;
+
+      // The state machine.  Rows in a sequence cover the code up to the
+      // next row.
+      reader p (program, unit_end);
+      uint32_t address = 0;
+      int64_t line = 1;
+      uint64_t file = 1;
+      bool have_row = false;
+      range last;
+
+      while (p.p < p.end && !p.error)
+	{
+	  unsigned op = p.u (1);
+	  bool emit = false, end_sequence = false;
+
+	  if (op >= opcode_base)
+	    {
+	      unsigned adj = op - opcode_base;
+
+	      address += (adj / line_range) * min_inst;
+	      line += line_base + (int) (adj % line_range);
+	      emit = true;
+	    }
+	  else if (op == 0)
+	    {
+	      uint64_t len = p.uleb ();
+	      const unsigned char *next = p.p + len;
+	      unsigned sub;
+
+	      if (len > (uint64_t) (p.end - p.p))
+		return -1;
+	      sub = len ? p.u (1) : 0;
+
+	      if (sub == DW_LNE_end_sequence)
+		emit = end_sequence = true;
+	      else if (sub == DW_LNE_set_address)
+		address = p.u (4);
+	      else if (sub == DW_LNE_define_file)
+		{
+		  const char *n = p.str ();
+		  uint64_t dir = p.uleb ();
+
+		  file_map.push_back (file_id (join (dir < dirs.size ()
+						     ? dirs[dir] : "", n)));
+		}
+	      p.p = next;
+	    }
+	  else if (op == DW_LNS_copy)
+	    emit = true;
+	  else if (op == DW_LNS_advance_pc)
+	    address += p.uleb () * min_inst;
+	  else if (op == DW_LNS_advance_line)
+	    line += p.sleb ();
+	  else if (op == DW_LNS_set_file)
+	    file = p.uleb ();
+	  else if (op == DW_LNS_const_add_pc)
+	    address += ((255 - opcode_base) / line_range) * min_inst;
+	  else if (op == DW_LNS_fixed_advance_pc)
+	    address += p.u (2);
+	  else
+	    for (unsigned i = 0; i < std_lengths[op - 1]; i++)
+	      p.uleb ();
+
+	  if (!emit)
+	    continue;
+
+	  if (have_row && address > last.start)
+	    {
+	      last.end = address;
+	      ranges.push_back (last);
+	    }
+
+	  last.start = address;
+	  last.file = file < file_map.size () ? file_map[file] : 0;
+	  last.line = line > 0 ? line : 0;
+	  have_row = !end_sequence;
+
+	  if (end_sequence)
+	    {
+	      address = 0;
+	      line = 1;
+	      file = 1;
+	    }
+	}
+      if (p.error)
+	return -1;
+    }
+
+  return unit.error ? -1 : 0;
+}
+
+const std::vector < line_table::range > &
+line_table::all ()
+{
+  if (!sorted)
+    {
+      std::stable_sort (ranges.begin (), ranges.end ());
+      sorted = true;
+    }
+  return ranges;
+}
+
+const line_table::range *
+line_table::lookup (uint32_t addr)
+{
+  const std::vector < range > &r = all ();
+  std::vector < range >::const_iterator it;
+  range key;
+
+  key.start = addr;
+  it = std::upper_bound (r.begin (), r.end (), key);
+  if (it == r.begin ())
+    return NULL;
+  --it;
+
+  return addr < it->end ? &*it : NULL;
+}
@@ -0,0 +1,84 @@
+// 'lines.h' - Source line information of guest programs
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LINES_H
+#define LINES_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Address to source line translation, built from the DWARF .debug_line
+// sections (versions 2 to 5) of 32-bit little-endian ELF files.  Both
+// compiled code and assembly built with 'as -g' carry them.
+class line_table
+{
+public:
+
+  // Code in [start, end) comes from LINE of source FILE.
+  struct range
+  {
+    uint32_t start;
+    uint32_t end;
+    unsigned file;
+    unsigned line;
+
+    bool operator< (const range & other) const
+    {
+      return start < other.start;
+    }
+  };
+
+  line_table ():sorted (true)
+  {
+  }
+
+  // Add the line information of ELF file FILE.  Files without it are
+  // not an error.  Returns 0 on success and -1 on failure.
+  int load (const char *file);
+
+  bool empty () const
+  {
+    return ranges.empty ();
+  }
+
+  // All ranges, sorted by address.
+  const std::vector < range > &all ();
+
+  // Range holding ADDR, or NULL if there is none.
+  const range *lookup (uint32_t addr);
+
+  const std::string & file_name (unsigned file) const
+  {
+    return files[file];
+  }
+
+private:
+
+  std::vector < range > ranges;
+  std::vector < std::string > files;
+  std::map < std::string, unsigned > file_ids;
+  bool sorted;
+
+  unsigned file_id (const std::string & name);
+  int parse (const unsigned char *data, size_t size,
+	     const unsigned char *line_str, size_t line_str_size,
+	     const unsigned char *str, size_t str_size);
+};
+
+#endif // !LINES_H.
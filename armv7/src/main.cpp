@@ -31,7 +31,9 @@
 // response until the end of cycle. After finishing the execution of one
 // instruction, SystemC kernel executes other modules threads and they
 // must prepare information so the next instruction of the ARM core may
-// observe external modules responses.
+// observe external modules responses.  With --quantum, the core may run
+// ahead of the other modules, synchronizing only when it accesses them
+// (see quantum.h).
 //
 // Author : Rafael Auler,            10/10/2011
 //          Gabriel Krisman Bertazi, 10/08/2012
@@ -53,7 +55,8 @@ const char *model_version = "2.0";
 #include "ac_stats_base.H"
 #include "arm_interrupts.h"
 
-#include "arm.H"
+#include "arm_core.h"
+#include "ac_sighandlers.H"
 #include "gpt.h"
 #include "tzic.h"
 #include "ram.h"
@@ -70,6 +73,24 @@ const char *model_version = "2.0";
 #include "src.h"
 #include "ccm.h"
 #include "pins.h"
+#include "idle.h"
+#include "quantum.h"
+#include "profiler.h"
+#include "counters.h"
+#include "host_profile.h"
+#include "trace.h"
+#include "cache.h"
+#include "pmu.h"
+#include "throughput.h"
+#include "coverage.h"
+#include "lines.h"
+#include "latency.h"
+#include "mmio_profile.h"
+#include "checkpoint.h"
+#include "replay.h"
+#include "history.h"
+#include "sampling.h"
+#include "kernel.h"
 
 #define iMX53_MODEL
 
@@ -94,12 +115,72 @@ static unsigned CYCLES = 0;
 static unsigned BATCH_SIZE = 100;
 static unsigned GDB_PORT = 5000;
 static bool ENABLE_GDB = false;
+static unsigned GDB_HISTORY = 0;
+static unsigned GDB_HISTORY_WINDOW = 10;
 static char *SYSCODE = 0;
 static char *BOOTCODE = 0;
+static char *KERNEL = 0;
+static char *DTB = 0;
+static char *CMDLINE = 0;
+static unsigned MACHINE = 3273;	// mx53_loco.
 static char *SDCARD = 0;
+static char *SD_OVERLAY = 0;
+static bool SD_COMMIT = false;
+static bool SD_DISCARD = false;
+static unsigned SD_CACHE_MB = 8;
+static unsigned SD_READAHEAD = 128;
+static bool IDLE_SKIP = false;
+static unsigned long long IDLE_MAX_SKIP = 100000;
+static unsigned long long QUANTUM = 1;
+static char *PROFILE = 0;
+static unsigned PROFILE_PERIOD = pc_profiler::DEFAULT_PERIOD;
+static char *SYMBOLS = 0;
+static char *STATS_JSON = 0;
+static unsigned STATS_INTERVAL = 0;
+static unsigned PROGRESS = 0;
+static char *PROGRESS_FILE = 0;
+static char *COVERAGE = 0;
+static char *COVERAGE_LCOV = 0;
+static bool IRQ_LATENCY = false;
+static unsigned MMIO_PROFILE = 0;
+static char *SAVE_CHECKPOINT = 0;
+static char *RESTORE_CHECKPOINT = 0;
+static unsigned CHECKPOINT_INTERVAL = 0;
+static char *RECORD_INPUT = 0;
+static char *REPLAY_INPUT = 0;
+static unsigned long long SAMPLE_EVERY = 0;
+static std::vector < uint64_t > SAMPLE_POINTS;
+static unsigned long long SAMPLE_WINDOW = 1000000;
+static unsigned long long SAMPLE_WARMUP = 1000000;
+static unsigned SAMPLE_JOBS = 0;
+static char *TRACE = 0;
+static unsigned long long TRACE_RING_SIZE = 0;
+static bool CACHE = false;
+static unsigned CACHE_REGION = 64;
+
+// Cortex-A8, as described by the cp15 cache identification registers.
+static cache_level::config CACHE_L1 =
+  { 32 * 1024, 4, 64, cache_level::REPLACE_LRU, true, true };
+static cache_level::config CACHE_L2 =
+  { 256 * 1024, 8, 64, cache_level::REPLACE_LRU, true, true };
 
 coprocessor *CP[16];
 MMU *mmu;
+idle_detector *idle_det;
+quantum_keeper *qkeeper;
+pc_profiler *profiler;
+sim_counters *counters;
+trace_recorder *tracer;
+memory_hierarchy *caches;
+pmu *perfmon;
+throughput_meter *meter;
+coverage_map *coverage;
+irq_latency *irq_stats;
+mmio_profile *mmio_stats;
+checkpoint *ckpt;
+host_input *inputs;
+history *hist;
+sampler *sampling;
 
 //--
 const char *argp_program_bug_address = "<krisman.gabriel@gmail.com>";
@@ -173,6 +254,94 @@ enum
   CMD_CLASS_CODE,
 };
 
+// Keys of options without a short form.
+enum
+{
+  OPT_SD_OVERLAY = 256,
+
+  OPT_SD_COMMIT,
+
+  OPT_SD_DISCARD,
+
+  OPT_SD_CACHE,
+
+  OPT_SD_READAHEAD,
+
+  OPT_IDLE_SKIP,
+
+  OPT_IDLE_MAX_SKIP,
+
+  OPT_QUANTUM,
+
+  OPT_PROFILE,
+
+  OPT_PROFILE_PERIOD,
+
+  OPT_SYMBOLS,
+
+  OPT_STATS_JSON,
+
+  OPT_STATS_INTERVAL,
+
+  OPT_TRACE,
+
+  OPT_TRACE_RING,
+
+  OPT_CACHE,
+
+  OPT_CACHE_L1,
+
+  OPT_CACHE_L2,
+
+  OPT_CACHE_POLICY,
+
+  OPT_CACHE_REGION,
+
+  OPT_PROGRESS,
+
+  OPT_PROGRESS_FILE,
+
+  OPT_COVERAGE,
+
+  OPT_COVERAGE_LCOV,
+
+  OPT_IRQ_LATENCY,
+
+  OPT_MMIO_PROFILE,
+
+  OPT_SAVE_CHECKPOINT,
+
+  OPT_CHECKPOINT_INTERVAL,
+
+  OPT_RESTORE_CHECKPOINT,
+
+  OPT_RECORD_INPUT,
+
+  OPT_REPLAY_INPUT,
+
+  OPT_GDB_HISTORY,
+
+  OPT_GDB_HISTORY_WINDOW,
+
+  OPT_SAMPLE_EVERY,
+
+  OPT_SAMPLE_AT,
+
+  OPT_SAMPLE_WINDOW,
+
+  OPT_SAMPLE_WARMUP,
+
+  OPT_SAMPLE_JOBS,
+
+  OPT_KERNEL,
+
+  OPT_DTB,
+
+  OPT_CMDLINE,
+
+  OPT_MACHINE,
+};
+
 // Command line options we can understand.
 static argp_option arm_model_options[] = {
   {"cycles", 'c', "<cycles>", 0,
@@ -183,6 +352,61 @@ static argp_option arm_model_options[] = {
    "Run n+1 processor cycles for each plataform cycle",
    CMD_CLASS_CTL},
 
+  {"quantum", OPT_QUANTUM, "<cycles>", 0,
+   "Let the core run up to <cycles> plataform cycles ahead of devices",
+   CMD_CLASS_CTL},
+
+  {"idle-skip", OPT_IDLE_SKIP, 0, 0,
+   "Skip simulated time while the core waits for interrupts or spins",
+   CMD_CLASS_CTL},
+
+  {"idle-max-skip", OPT_IDLE_MAX_SKIP, "<ns>", 0,
+   "Never skip more than <ns> nanoseconds at once (default 100000)",
+   CMD_CLASS_CTL},
+
+  {"save-checkpoint", OPT_SAVE_CHECKPOINT, "<file>", 0,
+   "Save the platform state to <file> when the simulation ends",
+   CMD_CLASS_CTL},
+
+  {"checkpoint-interval", OPT_CHECKPOINT_INTERVAL, "<seconds>", 0,
+   "Also save it to <file>.1, <file>.2... every <seconds> of host time, "
+   "all but the first as deltas",
+   CMD_CLASS_CTL},
+
+  {"restore-checkpoint", OPT_RESTORE_CHECKPOINT, "<file>", 0,
+   "Start from the platform state saved in <file>",
+   CMD_CLASS_CTL},
+
+  {"record-input", OPT_RECORD_INPUT, "<file>", 0,
+   "Log console input to <file>, so the run can be replayed",
+   CMD_CLASS_CTL},
+
+  {"replay-input", OPT_REPLAY_INPUT, "<file>", 0,
+   "Repeat a run recorded with --record-input, without reading stdin",
+   CMD_CLASS_CTL},
+
+  {"sample-every", OPT_SAMPLE_EVERY, "<millions>", 0,
+   "Run without caches or trace, but fork to measure a window with them "
+   "every <millions> of instructions",
+   CMD_CLASS_CTL},
+
+  {"sample-at", OPT_SAMPLE_AT, "<count>[,<count>...]", 0,
+   "Also fork to measure a window at these instruction counts",
+   CMD_CLASS_CTL},
+
+  {"sample-window", OPT_SAMPLE_WINDOW, "<instructions>", 0,
+   "Instructions measured by each window (default 1000000)",
+   CMD_CLASS_CTL},
+
+  {"sample-warmup", OPT_SAMPLE_WARMUP, "<instructions>", 0,
+   "Instructions run to warm caches up before each window (default "
+   "1000000)",
+   CMD_CLASS_CTL},
+
+  {"sample-jobs", OPT_SAMPLE_JOBS, "<n>", 0,
+   "Windows measured at once (default one less than host cores)",
+   CMD_CLASS_CTL},
+
   {"debug", 'D',
    "[core,][bus,][gpt,][tzic,][uart,][ram,][rom,][cp15,]\n"
    "[mmu,][sd,][esdhc,][dpllc,][ccm,][src]", 0,
@@ -193,6 +417,79 @@ static argp_option arm_model_options[] = {
    "Activate flow debug mode",
    CMD_CLASS_DEBUG},
 
+  {"cache", OPT_CACHE, 0, 0,
+   "Model L1I/L1D/L2 caches and report their hit rates",
+   CMD_CLASS_DEBUG},
+
+  {"cache-l1", OPT_CACHE_L1, "<KiB>,<ways>,<line>", 0,
+   "Geometry of each L1 cache (default 32,4,64)",
+   CMD_CLASS_DEBUG},
+
+  {"cache-l2", OPT_CACHE_L2, "<KiB>,<ways>,<line>", 0,
+   "Geometry of the L2 cache, 0 KiB for none (default 256,8,64)",
+   CMD_CLASS_DEBUG},
+
+  {"cache-policy", OPT_CACHE_POLICY, "<lru|random>,<wb|wt>", 0,
+   "Replacement and write policies of all caches (default lru,wb)",
+   CMD_CLASS_DEBUG},
+
+  {"cache-region", OPT_CACHE_REGION, "<bytes>", 0,
+   "Size of the code regions cache statistics are split into",
+   CMD_CLASS_DEBUG},
+
+  {"trace", OPT_TRACE, "<file>", 0,
+   "Record a compressed binary execution trace to <file> (see trdump)",
+   CMD_CLASS_DEBUG},
+
+  {"trace-ring", OPT_TRACE_RING, "<records>", 0,
+   "Keep only the last <records> of the trace, in a memory-mapped file",
+   CMD_CLASS_DEBUG},
+
+  {"irq-latency", OPT_IRQ_LATENCY, 0, 0,
+   "Report IRQ latency and handler duration histograms",
+   CMD_CLASS_DEBUG},
+
+  {"mmio-profile", OPT_MMIO_PROFILE, "<registers>", OPTION_ARG_OPTIONAL,
+   "Count accesses per device register and report the top <registers>"
+   " (default 20)",
+   CMD_CLASS_DEBUG},
+
+  {"coverage", OPT_COVERAGE, "<file>", 0,
+   "Accumulate executed instruction addresses in the bitmap <file>",
+   CMD_CLASS_DEBUG},
+
+  {"coverage-lcov", OPT_COVERAGE_LCOV, "<file>", 0,
+   "Write code coverage as an lcov tracefile to <file>",
+   CMD_CLASS_DEBUG},
+
+  {"profile", OPT_PROFILE, "<file>", 0,
+   "Sample guest PC and write a profile to <file> and <file>.folded",
+   CMD_CLASS_DEBUG},
+
+  {"profile-period", OPT_PROFILE_PERIOD, "<instructions>", 0,
+   "Take one profile sample every <instructions> (default 997)",
+   CMD_CLASS_DEBUG},
+
+  {"symbols", OPT_SYMBOLS, "<elf>[,<elf>]", 0,
+   "Name addresses in reports after symbols of these ELF files",
+   CMD_CLASS_DEBUG},
+
+  {"stats-json", OPT_STATS_JSON, "<file>", 0,
+   "Export counters as JSON to <file> on SIGUSR1 and at exit",
+   CMD_CLASS_DEBUG},
+
+  {"stats-interval", OPT_STATS_INTERVAL, "<seconds>", 0,
+   "Also export counters every <seconds> of host time",
+   CMD_CLASS_DEBUG},
+
+  {"progress", OPT_PROGRESS, "<seconds>", 0,
+   "Report MIPS, PC and simulated time every <seconds> of host time",
+   CMD_CLASS_DEBUG},
+
+  {"progress-file", OPT_PROGRESS_FILE, "<file>", 0,
+   "Rewrite progress reports as JSON in <file> (default every 10s)",
+   CMD_CLASS_DEBUG},
+
   {"enable-gdb", 'g', 0, 0,
    "Wait for GDB connection",
    CMD_CLASS_GDB},
@@ -201,6 +498,14 @@ static argp_option arm_model_options[] = {
    "Define port to expect a GDB connection",
    CMD_CLASS_GDB},
 
+  {"gdb-history", OPT_GDB_HISTORY, "<MiB>", 0,
+   "Keep up to <MiB> of snapshots, so GDB can step and continue backwards",
+   CMD_CLASS_GDB},
+
+  {"gdb-history-window", OPT_GDB_HISTORY_WINDOW, "<millions>", 0,
+   "How far back GDB can go, in millions of instructions (default 10)",
+   CMD_CLASS_GDB},
+
   {"rom", 'r', "<image>", 0,
    "Define bootstrapping ROM code image",
    CMD_CLASS_CODE},
@@ -209,10 +514,46 @@ static argp_option arm_model_options[] = {
    "Load image to SD card device",
    CMD_CLASS_CODE},
 
+  {"sd-overlay", OPT_SD_OVERLAY, "<file>", 0,
+   "Keep SD card writes in <file> across runs instead of a temporary file",
+   CMD_CLASS_CODE},
+
+  {"sd-commit", OPT_SD_COMMIT, 0, 0,
+   "Write SD card changes back to the image at exit",
+   CMD_CLASS_CODE},
+
+  {"sd-discard", OPT_SD_DISCARD, 0, 0,
+   "Drop changes kept in the SD overlay before starting",
+   CMD_CLASS_CODE},
+
+  {"sd-cache", OPT_SD_CACHE, "<MiB>", 0,
+   "Memory used to cache inflated chunks of compressed SD images",
+   CMD_CLASS_CODE},
+
+  {"sd-readahead", OPT_SD_READAHEAD, "<blocks>", 0,
+   "Prefetch <blocks> ahead of sequential SD reads (0 disables)",
+   CMD_CLASS_CODE},
+
   {"load-sys", 'y', "<file>", 0,
    "Load ELF image as system code",
    CMD_CLASS_CODE},
 
+  {"kernel", OPT_KERNEL, "<elf>", 0,
+   "Load ELF kernel into RAM and start it directly, without boot ROM or SD",
+   CMD_CLASS_CODE},
+
+  {"dtb", OPT_DTB, "<file>", 0,
+   "Pass a device tree to the --kernel instead of ATAGs",
+   CMD_CLASS_CODE},
+
+  {"cmdline", OPT_CMDLINE, "<string>", 0,
+   "Kernel command line, passed in the ATAGs",
+   CMD_CLASS_CODE},
+
+  {"machine", OPT_MACHINE, "<type>", 0,
+   "Machine type passed to the --kernel (default 3273, mx53_loco)",
+   CMD_CLASS_CODE},
+
   {NULL}
 };
 
@@ -282,6 +623,22 @@ parse_opt (int key, char *arg, struct argp_state *state)
       }
       break;
 
+    case OPT_GDB_HISTORY:
+      {
+	int r = sscanf (arg, "%u", &GDB_HISTORY);
+	if (r != 1 || GDB_HISTORY == 0)
+	  argp_error (state, "Invalid GDB history size");
+      }
+      break;
+
+    case OPT_GDB_HISTORY_WINDOW:
+      {
+	int r = sscanf (arg, "%u", &GDB_HISTORY_WINDOW);
+	if (r != 1 || GDB_HISTORY_WINDOW == 0)
+	  argp_error (state, "Invalid GDB history window");
+      }
+      break;
+
       // Define number of plataform simulation cycles
     case 'c':
       {
@@ -300,6 +657,235 @@ parse_opt (int key, char *arg, struct argp_state *state)
       }
       break;
 
+    case OPT_QUANTUM:
+      {
+	int r = sscanf (arg, "%llu", &QUANTUM);
+	if (r != 1 || QUANTUM == 0)
+	  argp_error (state, "Invalid quantum");
+      }
+      break;
+
+    case OPT_PROFILE:
+      PROFILE = strdup (arg);
+      break;
+
+    case OPT_PROFILE_PERIOD:
+      {
+	int r = sscanf (arg, "%u", &PROFILE_PERIOD);
+	if (r != 1 || PROFILE_PERIOD == 0)
+	  argp_error (state, "Invalid profile period");
+      }
+      break;
+
+    case OPT_SYMBOLS:
+      SYMBOLS = strdup (arg);
+      break;
+
+    case OPT_CACHE:
+      CACHE = true;
+      break;
+
+    case OPT_CACHE_L1:
+    case OPT_CACHE_L2:
+      {
+	cache_level::config *cfg = key == OPT_CACHE_L1 ? &CACHE_L1 : &CACHE_L2;
+	unsigned kib, ways, line;
+	int r = sscanf (arg, "%u,%u,%u", &kib, &ways, &line);
+
+	if (r != 3 || (kib == 0 && key == OPT_CACHE_L1))
+	  argp_error (state, "Invalid cache geometry '%s'", arg);
+	if (kib && (ways == 0 || line < 4 || (line & (line - 1))
+		    || (kib * 1024) % (ways * line)))
+	  argp_error (state, "Invalid cache geometry '%s'", arg);
+
+	cfg->size = kib * 1024;
+	cfg->ways = ways;
+	cfg->block_size = line;
+	CACHE = true;
+      }
+      break;
+
+    case OPT_CACHE_POLICY:
+      {
+	char replace[8], write[8];
+	int r = sscanf (arg, "%7[a-z],%7[a-z]", replace, write);
+	cache_level::replacement policy;
+	bool write_back;
+
+	if (r >= 1 && strcmp (replace, "lru") == 0)
+	  policy = cache_level::REPLACE_LRU;
+	else if (r >= 1 && strcmp (replace, "random") == 0)
+	  policy = cache_level::REPLACE_RANDOM;
+	else
+	  argp_error (state, "Invalid cache policy '%s'", arg);
+
+	if (r < 2 || strcmp (write, "wb") == 0)
+	  write_back = true;
+	else if (strcmp (write, "wt") == 0)
+	  write_back = false;
+	else
+	  argp_error (state, "Invalid cache policy '%s'", arg);
+
+	// Write-through caches usually don't allocate on writes.
+	CACHE_L1.policy = CACHE_L2.policy = policy;
+	CACHE_L1.write_back = CACHE_L2.write_back = write_back;
+	CACHE_L1.write_allocate = CACHE_L2.write_allocate = write_back;
+	CACHE = true;
+      }
+      break;
+
+    case OPT_CACHE_REGION:
+      {
+	int r = sscanf (arg, "%u", &CACHE_REGION);
+	if (r != 1 || CACHE_REGION == 0 || (CACHE_REGION & (CACHE_REGION - 1)))
+	  argp_error (state, "Cache region must be a power of two");
+	CACHE = true;
+      }
+      break;
+
+    case OPT_TRACE:
+      TRACE = strdup (arg);
+      break;
+
+    case OPT_TRACE_RING:
+      {
+	int r = sscanf (arg, "%llu", &TRACE_RING_SIZE);
+	if (r != 1 || TRACE_RING_SIZE == 0)
+	  argp_error (state, "Invalid trace ring size");
+      }
+      break;
+
+    case OPT_STATS_JSON:
+      STATS_JSON = strdup (arg);
+      break;
+
+    case OPT_STATS_INTERVAL:
+      {
+	int r = sscanf (arg, "%u", &STATS_INTERVAL);
+	if (r != 1)
+	  argp_error (state, "Invalid stats interval");
+      }
+      break;
+
+    case OPT_PROGRESS:
+      {
+	int r = sscanf (arg, "%u", &PROGRESS);
+	if (r != 1 || PROGRESS == 0)
+	  argp_error (state, "Invalid progress interval");
+      }
+      break;
+
+    case OPT_PROGRESS_FILE:
+      PROGRESS_FILE = strdup (arg);
+      break;
+
+    case OPT_IRQ_LATENCY:
+      IRQ_LATENCY = true;
+      break;
+
+    case OPT_MMIO_PROFILE:
+      MMIO_PROFILE = mmio_profile::DEFAULT_TOP;
+      if (arg != 0)
+	{
+	  int r = sscanf (arg, "%u", &MMIO_PROFILE);
+	  if (r != 1 || MMIO_PROFILE == 0)
+	    argp_error (state, "Invalid number of MMIO registers");
+	}
+      break;
+
+    case OPT_SAVE_CHECKPOINT:
+      SAVE_CHECKPOINT = strdup (arg);
+      break;
+
+    case OPT_CHECKPOINT_INTERVAL:
+      {
+	int r = sscanf (arg, "%u", &CHECKPOINT_INTERVAL);
+	if (r != 1)
+	  argp_error (state, "Invalid checkpoint interval");
+      }
+      break;
+
+    case OPT_RESTORE_CHECKPOINT:
+      RESTORE_CHECKPOINT = strdup (arg);
+      break;
+
+    case OPT_RECORD_INPUT:
+      RECORD_INPUT = strdup (arg);
+      break;
+
+    case OPT_REPLAY_INPUT:
+      REPLAY_INPUT = strdup (arg);
+      break;
+
+    case OPT_SAMPLE_EVERY:
+      {
+	int r = sscanf (arg, "%llu", &SAMPLE_EVERY);
+	if (r != 1 || SAMPLE_EVERY == 0)
+	  argp_error (state, "Invalid sample period");
+      }
+      break;
+
+    case OPT_SAMPLE_AT:
+      {
+	const char *p = arg;
+	char *end;
+
+	for (;;)
+	  {
+	    SAMPLE_POINTS.push_back (strtoull (p, &end, 0));
+	    if (end == p || (*end != ',' && *end != '\0'))
+	      argp_error (state, "Invalid sample instruction counts");
+	    if (*end == '\0')
+	      break;
+	    p = end + 1;
+	  }
+      }
+      break;
+
+    case OPT_SAMPLE_WINDOW:
+      {
+	int r = sscanf (arg, "%llu", &SAMPLE_WINDOW);
+	if (r != 1 || SAMPLE_WINDOW == 0)
+	  argp_error (state, "Invalid sample window");
+      }
+      break;
+
+    case OPT_SAMPLE_WARMUP:
+      {
+	int r = sscanf (arg, "%llu", &SAMPLE_WARMUP);
+	if (r != 1)
+	  argp_error (state, "Invalid sample warm-up");
+      }
+      break;
+
+    case OPT_SAMPLE_JOBS:
+      {
+	int r = sscanf (arg, "%u", &SAMPLE_JOBS);
+	if (r != 1 || SAMPLE_JOBS == 0)
+	  argp_error (state, "Invalid number of sample jobs");
+      }
+      break;
+
+    case OPT_COVERAGE:
+      COVERAGE = strdup (arg);
+      break;
+
+    case OPT_COVERAGE_LCOV:
+      COVERAGE_LCOV = strdup (arg);
+      break;
+
+    case OPT_IDLE_SKIP:
+      IDLE_SKIP = true;
+      break;
+
+    case OPT_IDLE_MAX_SKIP:
+      {
+	int r = sscanf (arg, "%llu", &IDLE_MAX_SKIP);
+	if (r != 1 || IDLE_MAX_SKIP == 0)
+	  argp_error (state, "Invalid idle skip limit");
+      }
+      break;
+
       // Inform bootstrapping code image path.
     case 'r':
       BOOTCODE = strdup (arg);
@@ -310,14 +896,86 @@ parse_opt (int key, char *arg, struct argp_state *state)
       SDCARD = strdup (arg);
       break;
 
+      // Inform SD CARD overlay path.
+    case OPT_SD_OVERLAY:
+      SD_OVERLAY = strdup (arg);
+      break;
+
+    case OPT_SD_COMMIT:
+      SD_COMMIT = true;
+      break;
+
+    case OPT_SD_DISCARD:
+      SD_DISCARD = true;
+      break;
+
+    case OPT_SD_CACHE:
+      {
+	int r = sscanf (arg, "%u", &SD_CACHE_MB);
+	if (r != 1 || SD_CACHE_MB == 0)
+	  argp_error (state, "Invalid SD cache size");
+      }
+      break;
+
+    case OPT_SD_READAHEAD:
+      {
+	int r = sscanf (arg, "%u", &SD_READAHEAD);
+	if (r != 1)
+	  argp_error (state, "Invalid SD read-ahead depth");
+      }
+      break;
+
       // Inform an ELF file path to be used as system code.
     case 'y':
       SYSCODE = strdup (arg);
       break;
 
+    case OPT_KERNEL:
+      KERNEL = strdup (arg);
+      break;
+
+    case OPT_DTB:
+      DTB = strdup (arg);
+      break;
+
+    case OPT_CMDLINE:
+      CMDLINE = strdup (arg);
+      break;
+
+    case OPT_MACHINE:
+      {
+	int r = sscanf (arg, "%u", &MACHINE);
+	if (r != 1)
+	  argp_error (state, "Invalid machine type");
+      }
+      break;
+
     case ARGP_KEY_END:
-      if (BOOTCODE == NULL)
+      // A kernel started directly doesn't need the boot code.
+      if (BOOTCODE == NULL && KERNEL == NULL)
         argp_usage (state);
+      if ((DTB != 0 || CMDLINE != 0) && KERNEL == 0)
+	argp_error (state, "--dtb and --cmdline need --kernel");
+      if (DTB != 0 && CMDLINE != 0)
+	argp_error (state, "With --dtb, the command line goes in the device "
+		    "tree");
+      if (CHECKPOINT_INTERVAL != 0 && SAVE_CHECKPOINT == 0)
+	argp_error (state, "Periodic checkpoints need --save-checkpoint");
+      // Compressed images are only read.
+      if (SD_COMMIT && SDCARD != 0
+	  && sd_compressed_image::is_compressed (SDCARD))
+	argp_error (state, "--sd-commit can't write back to a compressed "
+		    "image");
+      if (RECORD_INPUT != 0 && REPLAY_INPUT != 0)
+	argp_error (state, "Input can't be recorded and replayed at once");
+      // Both keep track of written memory, each since its own last save.
+      if (GDB_HISTORY != 0 && CHECKPOINT_INTERVAL != 0)
+	argp_error (state, "--gdb-history doesn't work with periodic "
+		    "checkpoints");
+      // GDB can't follow a run into its forks.
+      if ((SAMPLE_EVERY != 0 || !SAMPLE_POINTS.empty ())
+	  && (ENABLE_GDB || GDB_HISTORY != 0))
+	argp_error (state, "Sampled runs can't be debugged with GDB");
       break;
 
     default:
@@ -328,6 +986,22 @@ parse_opt (int key, char *arg, struct argp_state *state)
 
 static struct argp argp = { arm_model_options, parse_opt, 0, doc };
 
+// SIGUSR2 stops the guest for GDB, turning GDB support on if needed.
+// The generated core only installs the handler for USE_GDB builds, so
+// do it here for every build.
+static void
+install_gdb_break_handler ()
+{
+  struct sigaction sa;
+
+  memset (&sa, 0, sizeof (sa));
+  sa.sa_handler = sigusr2_handler;
+  sa.sa_flags = SA_RESTART;
+  sigemptyset (&sa.sa_mask);
+  if (sigaction (SIGUSR2, &sa, NULL) != 0)
+    perror ("ArchC: Unable to install the SIGUSR2 handler");
+}
+
 // Main function for ARM model simulator.
 int
 sc_main (int ac, char *av[])
@@ -335,10 +1009,118 @@ sc_main (int ac, char *av[])
   argp_program_version_hook = model_print_version;
   argp_parse (&argp, ac, av, 0, 0, 0);
 
+  // Instruction mix, exception and MMIO counters.
+  counters = new sim_counters ();
+  counters->set_output (STATS_JSON);
+
+  // Guest performance monitors.
+  perfmon = new pmu ();
+
+  // Simulation throughput.
+  if (PROGRESS_FILE != 0 && PROGRESS == 0)
+    PROGRESS = 10;
+  meter = new throughput_meter ();
+  meter->set_progress (PROGRESS, PROGRESS_FILE);
+
+  // Sampled simulation, with windows measured in forked processes.
+  if (SAMPLE_EVERY != 0 || !SAMPLE_POINTS.empty ())
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+
+      if (SAMPLE_JOBS == 0)
+	SAMPLE_JOBS = cpus > 1 ? cpus - 1 : 1;
+      sampling = new sampler (SAMPLE_WARMUP, SAMPLE_WINDOW, SAMPLE_JOBS);
+      sampling->set_points (SAMPLE_EVERY * 1000000, SAMPLE_POINTS);
+    }
+
+  // Execution trace.  Sampled runs only trace their windows.
+  if (TRACE != 0)
+    {
+      static const char *names[arm_parms::AC_DEC_INSTR_NUMBER + 1];
+
+      for (unsigned i = 0; i <= arm_parms::AC_DEC_INSTR_NUMBER; i++)
+	names[i] = arm_parms::arm_isa::instr_table[i].ac_instr_name;
+
+      if (sampling)
+	sampling->set_trace (TRACE, TRACE_RING_SIZE, names,
+			     arm_parms::AC_DEC_INSTR_NUMBER + 1);
+      else
+	{
+	  tracer = new trace_recorder ();
+	  if (tracer->open (TRACE, TRACE_RING_SIZE, names,
+			    arm_parms::AC_DEC_INSTR_NUMBER + 1) != 0)
+	    exit (1);
+	}
+    }
+
+  // Temporal decoupling of the core.
+  qkeeper = new quantum_keeper ();
+  qkeeper->set_global_quantum (QUANTUM);
+
+  // Idle detection.
+  idle_det = new idle_detector ();
+  idle_det->enabled = IDLE_SKIP;
+  idle_det->max_skip = IDLE_MAX_SKIP;
+
+  // Guest symbols, for reports, and source lines, for coverage.  System
+  // code and kernels are ELFs, so their symbols come for free.
+  symbol_table symbols;
+  line_table lines;
+  if (PROFILE != 0 || CACHE || COVERAGE_LCOV != 0)
+    {
+      if (SYSCODE != 0)
+	{
+	  symbols.load (SYSCODE);
+	  if (COVERAGE_LCOV != 0)
+	    lines.load (SYSCODE);
+	}
+      if (KERNEL != 0)
+	{
+	  symbols.load (KERNEL);
+	  if (COVERAGE_LCOV != 0)
+	    lines.load (KERNEL);
+	}
+      for (char *elf = SYMBOLS ? strtok (SYMBOLS, ",") : NULL; elf != NULL;
+	   elf = strtok (NULL, ","))
+	if (symbols.load (elf) != 0
+	    || (COVERAGE_LCOV != 0 && lines.load (elf) != 0))
+	  exit (1);
+    }
+
+  // Code coverage.  Bitmaps accumulate over runs.
+  if (COVERAGE != 0 || COVERAGE_LCOV != 0)
+    {
+      coverage = new coverage_map ();
+      if (COVERAGE != 0 && coverage->merge (COVERAGE) != 0)
+	exit (1);
+    }
+
+  // Guest profiling.
+  if (PROFILE != 0)
+    profiler = new pc_profiler (PROFILE_PERIOD);
+
+  // Memory hierarchy model.
+  if (CACHE)
+    caches = new memory_hierarchy (CACHE_L1, CACHE_L2, CACHE_REGION);
+
+  // Platform state, saved and restored device by device.
+  ckpt = new checkpoint ();
+
   // Devices
-  arm arm_proc1 ("arm");
+  arm_core arm_proc1 ("arm");
   imx53_bus ip_bus ("ip_bus");
 
+  // MMIO register profile.  Devices join it as they are connected.
+  if (MMIO_PROFILE != 0)
+    mmio_stats = new mmio_profile (&arm_proc1.ac_instr_counter, MMIO_PROFILE);
+
+  // Console input, from the host or from a recording of it.
+  inputs = new host_input (&arm_proc1.ac_instr_counter);
+  if (RECORD_INPUT != 0 && inputs->record (RECORD_INPUT) != 0)
+    exit (1);
+  if (REPLAY_INPUT != 0 && inputs->replay (REPLAY_INPUT) != 0)
+    exit (1);
+
 #ifdef iMX53_MODEL
   // Trust zone interrupt control.
   tzic_module tzic ("tzic");
@@ -383,14 +1165,22 @@ sc_main (int ac, char *av[])
   ccm_module ccm ("ccm", tzic);
 
   // If user included a sd card, create and connect it.
+  sd_card *sdcard = NULL;
   if (SDCARD)
-      esdhc1.connect_card (new sd_card ("microSD", SDCARD));
+    {
+      sdcard = new sd_card ("microSD", SDCARD, SD_OVERLAY, SD_DISCARD);
+      sdcard->set_cache_size ((size_t) SD_CACHE_MB << 20);
+      sdcard->set_readahead (SD_READAHEAD);
+      esdhc1.connect_card (sdcard);
+      if (sampling)
+	sampling->set_sd_card (sdcard);
+    }
 
   // Device's connection to the bus.
   // Peripheral Memory Map.
-  ip_bus.connect_device (&ddr1, 0x70000000, 0xAFFFFFFF);
-  ip_bus.connect_device (&ddr2, 0xB0000000, 0xEFFFFFFF);
-  ip_bus.connect_device (&bootmem, 0x00000000, 0x000FFFFF);
+  ip_bus.connect_device (&ddr1, 0x70000000, 0xAFFFFFFF, false);
+  ip_bus.connect_device (&ddr2, 0xB0000000, 0xEFFFFFFF, false);
+  ip_bus.connect_device (&bootmem, 0x00000000, 0x000FFFFF, false);
   ip_bus.connect_device (&tzic, 0x0FFFC000, 0x0FFFFFFF);
   ip_bus.connect_device (&esdhc1, 0x50004000, 0x50007FFF);
   ip_bus.connect_device (&gpt, 0x53FA0000, 0x53FA3FFF);
@@ -401,13 +1191,43 @@ sc_main (int ac, char *av[])
   ip_bus.connect_device (&dpllc2, 0x63F84000, 0x63F87FFF);
   ip_bus.connect_device (&dpllc3, 0x63F88000, 0x63F8bFFF);
   ip_bus.connect_device (&dpllc4, 0x63F8C000, 0x63F8FFFF);
-  ip_bus.connect_device (&iram, 0xF8000000, 0xF801FFFF);
+  ip_bus.connect_device (&iram, 0xF8000000, 0xF801FFFF, false);
+
+  // The boot ROM is given on the command line every time.
+  ckpt->add (tzic.name (), &tzic);
+  ckpt->add (gpt.name (), &gpt);
+  ckpt->add (uart.name (), &uart);
+  ckpt->add (esdhc1.name (), &esdhc1);
+  if (sdcard)
+    ckpt->add (sdcard->name (), sdcard);
+  ckpt->add (dpllc1.name (), &dpllc1);
+  ckpt->add (dpllc2.name (), &dpllc2);
+  ckpt->add (dpllc3.name (), &dpllc3);
+  ckpt->add (dpllc4.name (), &dpllc4);
+  ckpt->add (src.name (), &src);
+  ckpt->add (ccm.name (), &ccm);
+  ckpt->add (iram.name (), &iram, CHECKPOINT_PAGES);
+  ckpt->add (ddr1.name (), &ddr1, CHECKPOINT_PAGES);
+  ckpt->add (ddr2.name (), &ddr2, CHECKPOINT_PAGES);
+
+  // Only memories are cacheable.
+  if (caches)
+    {
+      caches->add_cacheable (0x70000000, 0xEFFFFFFF);
+      caches->add_cacheable (0x00000000, 0x000FFFFF);
+      caches->add_cacheable (0xF8000000, 0xF801FFFF);
+    }
+
+  // Devices that move on their own while the core is idle.
+  idle_det->add_source (&gpt);
+  idle_det->add_source (&uart);
+  idle_det->add_source (&esdhc1);
 
 #else // iMX53_MODEL.
 
   // Main Memory.
   ram_module bootmem ("mainMem", tzic, 0x1000000);
-  ip_bus.connect_device (&bootmem, 0x0, 0xFFFFF);
+  ip_bus.connect_device (&bootmem, 0x0, 0xFFFFF, false);
 
 #endif // !iMX53_MODEL.
 
@@ -419,13 +1239,25 @@ sc_main (int ac, char *av[])
   // Memory Management Unit
   mmu = new MMU ("MMU", *((cp15 *) CP[15]), ip_bus);
 
+  // The MMU has no state of its own: translation tables are in memory
+  // and its configuration is in cp15.
+  ckpt->add (arm_proc1.name (), &arm_proc1);
+  ckpt->add (((cp15 *) CP[15])->name (), (cp15 *) CP[15]);
+  ckpt->add ("console", inputs);
+  ckpt->add ("pmu", perfmon);
+
 #ifdef AC_DEBUG
   ac_trace ("arm_proc1.trace");
 #endif
 
   arm_proc1.set_instr_batch_size (BATCH_SIZE);
 
+  // Interrupt latency, timed by core instructions.
+  if (IRQ_LATENCY)
+    irq_stats = new irq_latency (&arm_proc1.ac_instr_counter);
+
   tzic.proc_port (arm_proc1.inta);
+  perfmon->connect (&tzic);
   ip_bus.proc_port (arm_proc1.inta);
   arm_proc1.MEM_port (*mmu);
 
@@ -442,6 +1274,8 @@ sc_main (int ac, char *av[])
       arm_proc1.enable_gdb (GDB_PORT);
     }
   arm_proc1.init (ac, av);
+  counters->install_handlers (STATS_INTERVAL);
+  install_gdb_break_handler ();
   cerr << endl;
 
   double duration = CYCLES;
@@ -453,6 +1287,23 @@ sc_main (int ac, char *av[])
   arm_proc1.ac_heap_ptr = 10485700;
   //  arm_proc1.dec_cache_size = arm_proc1.ac_heap_ptr;
   arm_proc1.dec_cache_size = 0xFFFF;
+
+  // Direct kernel boot.  ATAGs go where boot loaders usually leave
+  // them, and the device tree 128MiB into RAM, clear of the kernel.  A
+  // restored checkpoint already has the kernel running.
+  if (KERNEL != 0 && RESTORE_CHECKPOINT == 0)
+    {
+      kernel_loader loader;
+      uint32_t tags = DTB != 0 ? 0x78000000 : 0x70000100;
+
+      loader.add_memory (&ddr1, 0x70000000);
+      loader.add_memory (&ddr2, 0xB0000000);
+      if (loader.load_elf (KERNEL) != 0
+	  || (DTB != 0 ? loader.load_dtb (DTB, tags)
+	      : loader.write_atags (tags, CMDLINE)) != 0)
+	exit (1);
+      arm_proc1.boot_kernel (loader.entry (), MACHINE, tags);
+    }
 #else
   if (SYSCODE != 0)
     {
@@ -461,9 +1312,79 @@ sc_main (int ac, char *av[])
       arm_proc1.dec_cache_size = arm_proc1.ac_heap_ptr;
     }
 #endif
+  if (RESTORE_CHECKPOINT != 0 && ckpt->restore (RESTORE_CHECKPOINT) != 0)
+    exit (1);
+
+  if (CHECKPOINT_INTERVAL != 0)
+    ckpt->set_periodic (SAVE_CHECKPOINT, CHECKPOINT_INTERVAL);
+
+#ifdef iMX53_MODEL
+  // Recent history, for GDB to go back in.
+  if (GDB_HISTORY != 0)
+    {
+      hist = new history (*ckpt, (size_t) GDB_HISTORY << 20,
+			  GDB_HISTORY_WINDOW * 1000000ULL);
+      hist->add (&iram);
+      hist->add (&ddr1);
+      hist->add (&ddr2);
+    }
+#endif
+
+  // Sampled runs go on without the detailed models, which only come up
+  // in windows.
+  if (sampling)
+    {
+      sampling->set_caches (caches);
+      caches = NULL;
+      if (sampling->start (arm_proc1.ac_instr_counter) != 0)
+	exit (1);
+    }
+
+  HOST_PROFILE_START ();
+  meter->start ();
   sc_start (duration, SC_NS);
 
+  // A window still running ends here.  The parent waits for them all.
+  if (sampling)
+    sampling->finish (arm_proc1.ac_instr_counter);
+
+  if (SAVE_CHECKPOINT != 0)
+    {
+      // The core may be waiting for a device in the middle of an
+      // instruction.  Let it finish.
+      while (!arm_proc1.ac_stop_flag && qkeeper->in_instruction ())
+	sc_start (1, SC_NS);
+      if (ckpt->save (SAVE_CHECKPOINT, arm_proc1.ac_instr_counter,
+		     (uint64_t) (sc_time_stamp ().to_seconds () * 1e9)) != 0)
+	exit (1);
+    }
+
   arm_proc1.PrintStat ();
+  qkeeper->print_stats (stderr);
+  idle_det->print_stats (stderr);
+  if (profiler)
+    profiler->write (PROFILE, symbols);
+  if (caches)
+    caches->print_stats (stderr, symbols);
+  if (sampling)
+    sampling->print_stats (stderr);
+  if (irq_stats)
+    irq_stats->print_stats (stderr);
+  if (mmio_stats)
+    mmio_stats->print_stats (stderr);
+  inputs->print_stats (stderr);
+  if (coverage)
+    {
+      coverage->print_stats (stderr);
+      if (COVERAGE != 0 && coverage->save (COVERAGE) != 0)
+	exit (1);
+      if (COVERAGE_LCOV != 0
+	  && coverage->write_lcov (COVERAGE_LCOV, symbols, lines) != 0)
+	exit (1);
+    }
+  if (STATS_JSON != 0)
+    counters->dump ();
+  HOST_PROFILE_REPORT (stderr);
   cerr << endl;
 
 #ifdef AC_STATS
@@ -473,6 +1394,59 @@ sc_main (int ac, char *av[])
 #ifdef AC_DEBUG
   ac_close_trace ();
 #endif
+
+#ifdef iMX53_MODEL
+  if (sdcard != NULL)
+    {
+      if (SD_COMMIT && sdcard->commit_overlay () != 0)
+	{
+	  fprintf (stderr, "ArchC: SD card changes were not written back to "
+		   "%s\n", SDCARD);
+	  exit (1);
+	}
+      delete sdcard;
+    }
+#endif
+
+  delete profiler;
+  delete tracer;
+  delete caches;
+  delete coverage;
+  delete irq_stats;
+  delete mmio_stats;
+  delete idle_det;
+  delete qkeeper;
+  delete counters;
+  delete perfmon;
+  delete meter;
+  delete hist;
+  delete sampling;
+  delete ckpt;
+  delete inputs;
+
+  if (PROFILE != 0)
+    free (PROFILE);
+  if (SYMBOLS != 0)
+    free (SYMBOLS);
+  if (STATS_JSON != 0)
+    free (STATS_JSON);
+  if (PROGRESS_FILE != 0)
+    free (PROGRESS_FILE);
+  if (COVERAGE != 0)
+    free (COVERAGE);
+  if (COVERAGE_LCOV != 0)
+    free (COVERAGE_LCOV);
+  if (TRACE != 0)
+    free (TRACE);
+  if (SAVE_CHECKPOINT != 0)
+    free (SAVE_CHECKPOINT);
+  if (RESTORE_CHECKPOINT != 0)
+    free (RESTORE_CHECKPOINT);
+  if (RECORD_INPUT != 0)
+    free (RECORD_INPUT);
+  if (REPLAY_INPUT != 0)
+    free (REPLAY_INPUT);
+
   if (SYSCODE != 0)
     free (SYSCODE);
 
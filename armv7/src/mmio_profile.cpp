@@ -0,0 +1,128 @@
+// 'mmio_profile.cpp' - MMIO register access profile
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "mmio_profile.h"
+
+#include <algorithm>
+#include <string.h>
+
+// Width of the widest heatmap bar.
+static const unsigned BAR_WIDTH = 40;
+
+mmio_profile::mmio_profile (const unsigned long long *instructions_,
+			    unsigned top_):
+instructions (instructions_), top (top_)
+{
+}
+
+unsigned
+mmio_profile::add_device (const char *name, uint32_t start, uint32_t end)
+{
+  device d;
+
+  d.name = name;
+  d.start = start;
+  d.regs.resize ((end - start) / 4 + 1);
+  memset (&d.regs[0], 0, d.regs.size () * sizeof (reg));
+
+  devices.push_back (d);
+  return devices.size () - 1;
+}
+
+// A register in the report.
+struct mmio_entry
+{
+  unsigned device;
+  uint32_t offset;
+  uint64_t accesses;
+
+  bool operator< (const mmio_entry & o) const
+  {
+    return accesses > o.accesses;
+  }
+};
+
+void
+mmio_profile::print_stats (FILE * stream) const
+{
+  std::vector < uint64_t > totals (devices.size (), 0);
+  std::vector < mmio_entry > entries;
+  uint64_t total = 0, peak = 0;
+
+  for (unsigned i = 0; i < devices.size (); i++)
+    for (uint32_t n = 0; n < devices[i].regs.size (); n++)
+      {
+	const reg & r = devices[i].regs[n];
+	mmio_entry e;
+
+	if (r.reads == 0 && r.writes == 0)
+	  continue;
+
+	e.device = i;
+	e.offset = n * 4;
+	e.accesses = r.reads + r.writes;
+	entries.push_back (e);
+	totals[i] += e.accesses;
+      }
+
+  for (unsigned i = 0; i < devices.size (); i++)
+    {
+      total += totals[i];
+      peak = std::max (peak, totals[i]);
+    }
+
+  if (total == 0)
+    return;
+
+  fprintf (stream, "ArchC: MMIO accesses per device:\n");
+  for (unsigned i = 0; i < devices.size (); i++)
+    {
+      unsigned width = totals[i] * BAR_WIDTH / peak;
+      char bar[BAR_WIDTH + 1];
+
+      if (totals[i] == 0)
+	continue;
+
+      memset (bar, '#', width);
+      bar[width] = '\0';
+      fprintf (stream, "ArchC:   %-12s %12llu %5.1f%% %s\n", devices[i].name,
+	       (unsigned long long) totals[i], 100.0 * totals[i] / total,
+	       bar);
+    }
+
+  std::sort (entries.begin (), entries.end ());
+  if (entries.size () > top)
+    entries.resize (top);
+
+  fprintf (stream, "ArchC: Most accessed MMIO registers:\n");
+  fprintf (stream, "ArchC:   %-12s %-10s %12s %12s %14s\n", "device",
+	   "address", "reads", "writes", "avg distance");
+  for (size_t i = 0; i < entries.size (); i++)
+    {
+      const device & d = devices[entries[i].device];
+      const reg & r = d.regs[entries[i].offset / 4];
+
+      fprintf (stream, "ArchC:   %-12s 0x%08X %12llu %12llu ", d.name,
+	       d.start + entries[i].offset, (unsigned long long) r.reads,
+	       (unsigned long long) r.writes);
+      if (entries[i].accesses > 1)
+	fprintf (stream, "%14.1f\n",
+		 (double) r.distance / (entries[i].accesses - 1));
+      else
+	fprintf (stream, "%14s\n", "-");
+    }
+}
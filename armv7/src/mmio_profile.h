@@ -0,0 +1,87 @@
+// 'mmio_profile.h' - MMIO register access profile
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MMIO_PROFILE_H
+#define MMIO_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Reads and writes per device and register, for finding the status
+// registers drivers poll.  Every 32-bit register of a device window has
+// its own slot, so an access costs an index and a few adds.  Besides
+// the counts, each register keeps the number of instructions between
+// consecutive accesses to it; a small average means a polling loop.
+class mmio_profile
+{
+public:
+
+  static const unsigned DEFAULT_TOP = 20;
+
+  // INSTRUCTIONS is the core instruction counter.  TOP is how many
+  // registers the report lists.
+  mmio_profile (const unsigned long long *instructions, unsigned top);
+
+  // Register the bus window [START, END] of device NAME.  Returns the
+  // index for access.
+  unsigned add_device (const char *name, uint32_t start, uint32_t end);
+
+  // The core accessed OFFSET bytes into DEVICE.
+  void access (unsigned device, uint32_t offset, bool write)
+  {
+    reg & r = devices[device].regs[offset / 4];
+    uint64_t now = *instructions;
+
+    if (r.reads || r.writes)
+      r.distance += now - r.last;
+    r.last = now;
+    if (write)
+      r.writes++;
+    else
+      r.reads++;
+  }
+
+  void print_stats (FILE * stream) const;
+
+private:
+
+  struct reg
+  {
+    uint64_t reads;
+    uint64_t writes;
+
+    // Instruction count at the last access, and the sum of the
+    // distances between accesses.
+    uint64_t last;
+    uint64_t distance;
+  };
+
+  struct device
+  {
+    const char *name;
+    uint32_t start;
+    std::vector < reg > regs;
+  };
+
+  const unsigned long long *instructions;
+  unsigned top;
+
+  std::vector < device > devices;
+};
+
+#endif // !MMIO_PROFILE_H.
@@ -22,6 +22,12 @@
 // ----------------------------------------------------------------------
 
 #include<mmu.h>
+#include "host_profile.h"
+#include "cache.h"
+#include "pmu.h"
+
+extern memory_hierarchy *caches;
+extern pmu *perfmon;
 
 // TLB is still not complete. It might present some issues when multiprocessing.
 //So, lets keep it down for now.
@@ -118,6 +124,7 @@ MMU::talk_to_bus (ac_tlm_req_type type, unsigned address, unsigned datum)
 // receives the memory word for the virtual address requested.
 ac_tlm_rsp MMU::transport (const ac_tlm_req & req)
 {
+  HOST_PROFILE_SCOPE (HP_MMU);
   uint32_t phy_address;
 
 #ifdef WITH_TLB
@@ -129,6 +136,8 @@ ac_tlm_rsp MMU::transport (const ac_tlm_req & req)
       dprintf ("|| MMU Operation: <> MMU is: OFF: "
                "bypassing: Physical Address matches Virtual Address\n");
 
+      if (caches)
+        caches->access (req.addr, req.type == WRITE);
       return talk_to_bus (req);
     }
   dprintf ("|| MMU Operation: <> MMU is: ON:\n");
@@ -140,16 +149,21 @@ ac_tlm_rsp MMU::transport (const ac_tlm_req & req)
   if (tlb_p->fetch_item (req.addr>>12, &phy_address) == false)
     {
       // Perform L1 translation.
+      perfmon->tlb_refill ();
       phy_address = L1::translate (*this, req.addr);
       tlb_p->insert_item (req.addr>>12, (phy_address & ~0xFFF));
     }
   phy_address |= (req.addr & 0xFFF);
 
 #else // !WITH_TLB
-  // Perform L1 translation.
+  // Perform L1 translation.  Without a TLB, every access walks the
+  // tables, and there are no TLB refills for the PMU to count.
   phy_address = L1::translate (*this, req.addr);
 #endif // WITH_TLB
 
+  if (caches)
+    caches->access (phy_address, req.type == WRITE);
+
   // Redispatch with translated physical address.
   return talk_to_bus (req.type, phy_address, req.data);
 }
@@ -0,0 +1,290 @@
+// 'pmu.cpp' - Performance monitor unit
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "pmu.h"
+#include "cache.h"
+#include "cp15.h"
+#include "tzic.h"
+
+#include <string.h>
+
+extern bool DEBUG_CP15;
+extern memory_hierarchy *caches;
+
+#define dprintf(args...) if(DEBUG_CP15){fprintf(stderr,args);}
+
+pmu::pmu ():
+fetching (false), tzic (NULL), control (0), enabled (0), overflow (0),
+interrupts (0), selected (0), user_enable (0), armed (false),
+asserted (false)
+{
+  memset (events, 0, sizeof (events));
+  memset (counters, 0, sizeof (counters));
+  counters[CYCLE_COUNTER].type = CYCLES;
+}
+
+uint64_t
+pmu::raw (unsigned type) const
+{
+  switch (type)
+    {
+    case L1I_REFILL:
+      return caches ? caches->instruction_l1 ().read_misses : 0;
+    case L1D_REFILL:
+      return caches ? caches->data_l1 ().read_misses
+	+ caches->data_l1 ().write_misses : 0;
+    case L1D_ACCESS:
+      return caches ? caches->data_l1 ().reads + caches->data_l1 ().writes : 0;
+    case CYCLES:
+    case A8_CYCLES:
+      return events[INSTRUCTION];
+    }
+
+  // Software increments are applied to the counters directly.
+  return type > SW_INCR && type < N_EVENTS ? events[type] : 0;
+}
+
+bool
+pmu::running (unsigned i) const
+{
+  return (control & PMCR_E) && (enabled & bit (i));
+}
+
+// Bring counter I up to date, flagging it if it wrapped around.
+void
+pmu::settle (unsigned i)
+{
+  counter & c = counters[i];
+  uint64_t div = i == CYCLE_COUNTER && (control & PMCR_D) ? 64 : 1;
+  uint64_t ticks, total;
+
+  if (!running (i))
+    return;
+
+  // Keep what was not enough for a tick for the next update.
+  ticks = (raw (c.type) - c.base) / div;
+  total = (uint64_t) c.value + ticks;
+  c.base += ticks * div;
+  c.value = (uint32_t) total;
+  if (total >> 32)
+    overflow |= bit (i);
+}
+
+void
+pmu::settle_all ()
+{
+  for (unsigned i = 0; i <= N_COUNTERS; i++)
+    settle (i);
+}
+
+// Counters that start running begin from the current raw totals.
+void
+pmu::reconfigure (uint32_t new_control, uint32_t new_enabled)
+{
+  bool was_running[N_COUNTERS + 1];
+
+  for (unsigned i = 0; i <= N_COUNTERS; i++)
+    {
+      settle (i);
+      was_running[i] = running (i);
+    }
+
+  control = new_control;
+  enabled = new_enabled;
+
+  for (unsigned i = 0; i <= N_COUNTERS; i++)
+    if (!was_running[i] && running (i))
+      counters[i].base = raw (counters[i].type);
+}
+
+void
+pmu::update_interrupt ()
+{
+  bool level;
+
+  for (unsigned i = 0; i <= N_COUNTERS; i++)
+    if (interrupts & bit (i))
+      settle (i);
+
+  armed = (control & PMCR_E) && (enabled & interrupts);
+  level = (overflow & interrupts) != 0;
+  if (level == asserted || tzic == NULL)
+    return;
+
+  dprintf ("PMU: %s overflow interrupt\n", level ? "Asserted" : "Cleared");
+  asserted = level;
+  tzic->interrupt (PMU_IRQNUM, /*deassert= */ !level);
+}
+
+uint32_t
+pmu::read (unsigned hash)
+{
+  uint32_t value = 0;
+
+  switch (hash)
+    {
+    case cp15::PERFORMANCE_MONITOR_CONTROL:
+      value = PMCR_ID | control;
+      break;
+    case cp15::COUNT_ENABLE_SET:
+    case cp15::COUNT_ENABLE_CLEAR:
+      value = enabled;
+      break;
+    case cp15::OVERFLOW_FLAG_STATUS:
+      settle_all ();
+      value = overflow;
+      break;
+    case cp15::PERFORMANCE_COUNTER_SELECTION:
+      value = selected;
+      break;
+    case cp15::CYCLE_COUNT:
+      settle (CYCLE_COUNTER);
+      value = counters[CYCLE_COUNTER].value;
+      break;
+    case cp15::EVENT_SELECTION:
+      if (selected < N_COUNTERS)
+	value = counters[selected].type;
+      break;
+    case cp15::PERFORMANCE_MONITOR_COUNT:
+      if (selected < N_COUNTERS)
+	{
+	  settle (selected);
+	  value = counters[selected].value;
+	}
+      break;
+    case cp15::USER_ENABLE:
+      value = user_enable;
+      break;
+    case cp15::INTERRUPT_ENABLE_SET:
+    case cp15::INTERRUPT_ENABLE_CLEAR:
+      value = interrupts;
+      break;
+    }
+
+  // A read may have found an overflow.
+  update_interrupt ();
+  return value;
+}
+
+void
+pmu::write (unsigned hash, uint32_t value)
+{
+  dprintf ("PMU: Write 0x%X to register 0x%04X\n", value, hash);
+
+  switch (hash)
+    {
+    case cp15::PERFORMANCE_MONITOR_CONTROL:
+      reconfigure (value & PMCR_WRITABLE & ~(PMCR_P | PMCR_C), enabled);
+      if (value & PMCR_P)
+	for (unsigned i = 0; i < N_COUNTERS; i++)
+	  counters[i].value = 0;
+      if (value & PMCR_C)
+	counters[CYCLE_COUNTER].value = 0;
+      break;
+    case cp15::COUNT_ENABLE_SET:
+      reconfigure (control, enabled | (value & COUNTER_MASK));
+      break;
+    case cp15::COUNT_ENABLE_CLEAR:
+      reconfigure (control, enabled & ~value);
+      break;
+    case cp15::OVERFLOW_FLAG_STATUS:
+      settle_all ();
+      overflow &= ~value;
+      break;
+    case cp15::SOFTWARE_INCREMENT:
+      for (unsigned i = 0; i < N_COUNTERS; i++)
+	if ((value & bit (i)) && counters[i].type == SW_INCR && running (i)
+	    && ++counters[i].value == 0)
+	  overflow |= bit (i);
+      break;
+    case cp15::PERFORMANCE_COUNTER_SELECTION:
+      selected = value & 0x1F;
+      break;
+    case cp15::CYCLE_COUNT:
+      settle (CYCLE_COUNTER);
+      counters[CYCLE_COUNTER].value = value;
+      break;
+    case cp15::EVENT_SELECTION:
+      if (selected < N_COUNTERS)
+	{
+	  settle (selected);
+	  counters[selected].type = value & 0xFF;
+	  counters[selected].base = raw (counters[selected].type);
+	}
+      break;
+    case cp15::PERFORMANCE_MONITOR_COUNT:
+      if (selected < N_COUNTERS)
+	{
+	  settle (selected);
+	  counters[selected].value = value;
+	}
+      break;
+    case cp15::USER_ENABLE:
+      user_enable = value & 0x1;
+      break;
+    case cp15::INTERRUPT_ENABLE_SET:
+      settle_all ();
+      interrupts |= value & COUNTER_MASK;
+      break;
+    case cp15::INTERRUPT_ENABLE_CLEAR:
+      // Settle first, so an overflow that happened while the interrupt
+      // was enabled is still flagged, and the line drops below.
+      settle_all ();
+      interrupts &= ~value & COUNTER_MASK;
+      break;
+    }
+
+  update_interrupt ();
+}
+
+// Raw totals start over in a restored run, and are ahead of a snapshot
+// rewound to by GDB, so counters keep their values and how far they
+// are into the next tick, and are rebased on the current totals.
+void
+pmu::checkpoint_state (checkpoint & c)
+{
+  uint64_t partial[N_COUNTERS + 1];
+
+  if (c.saving ())
+    settle_all ();
+
+  for (unsigned i = 0; i <= N_COUNTERS; i++)
+    {
+      partial[i] = running (i) ? raw (counters[i].type) - counters[i].base
+	: 0;
+      c.io (counters[i].value);
+      c.io (counters[i].type);
+      c.io (partial[i]);
+    }
+
+  c.io (control);
+  c.io (enabled);
+  c.io (overflow);
+  c.io (interrupts);
+  c.io (selected);
+  c.io (user_enable);
+
+  // Whether the TZIC line is up, which the TZIC saves on its side.
+  c.io (asserted);
+
+  if (c.saving ())
+    return;
+
+  for (unsigned i = 0; i <= N_COUNTERS; i++)
+    counters[i].base = raw (counters[i].type) - partial[i];
+  armed = (control & PMCR_E) && (enabled & interrupts);
+}
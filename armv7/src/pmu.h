@@ -0,0 +1,166 @@
+// 'pmu.h' - Performance monitor unit
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PMU_H
+#define PMU_H
+
+#include <stdint.h>
+
+#include "checkpoint.h"
+
+class tzic_module;
+
+// Cortex-A8 performance monitors, as seen through cp15 c9: a cycle
+// counter and four event counters, with overflow interrupts.
+//
+// The simulator only keeps raw totals of each event, bumped on the
+// dispatch path.  A guest counter remembers the raw total it started
+// from and is brought up to date when the guest reads it, when its
+// configuration changes, and between instruction batches if it may
+// raise an interrupt, so counting costs nothing more than the totals.
+// This model is functional, so a cycle is an instruction.
+class pmu:public checkpointable
+{
+public:
+
+  // ARMv7 common event numbers.  Cache events are only counted when
+  // the memory hierarchy is modelled, and TLB refills only when the
+  // MMU is built with its TLB, which mmu.cpp leaves out.
+  enum event
+  {
+    SW_INCR = 0x00,
+    L1I_REFILL = 0x01,
+    ITLB_REFILL = 0x02,
+    L1D_REFILL = 0x03,
+    L1D_ACCESS = 0x04,
+    DTLB_REFILL = 0x05,
+    LOAD = 0x06,
+    STORE = 0x07,
+    INSTRUCTION = 0x08,
+    EXCEPTION = 0x09,
+    PC_WRITE = 0x0C,
+    BRANCH_IMMEDIATE = 0x0D,
+    CYCLES = 0x11,
+    N_EVENTS,
+
+    // Cortex-A8 specific cycle event.
+    A8_CYCLES = 0xFF
+  };
+
+  static const unsigned N_COUNTERS = 4;
+
+  // iMX53 interrupt line of the core PMU.
+  static const unsigned PMU_IRQNUM = 77;
+
+  pmu ();
+
+  // Overflow interrupts go to TZIC.
+  void connect (tzic_module * tzic_)
+  {
+    tzic = tzic_;
+  }
+
+  void count (event e)
+  {
+    events[e]++;
+  }
+
+  // Set by the core while it fetches instructions, so translations
+  // are told apart as instruction or data TLB refills.
+  bool fetching;
+
+  // Called by the MMU when a translation misses its TLB.
+  void tlb_refill ()
+  {
+    events[fetching ? ITLB_REFILL : DTLB_REFILL]++;
+  }
+
+  // Whether the cp15 register with this hash belongs to the PMU, that
+  // is, CRn = 9, opc1 = 0 and CRm = 12 to 14.
+  static bool is_register (unsigned hash)
+  {
+    return (hash & 0xFF00) == 0x9000 && ((hash >> 4) & 0xF) >= 12
+      && ((hash >> 4) & 0xF) <= 14;
+  }
+
+  uint32_t read (unsigned hash);
+  void write (unsigned hash, uint32_t value);
+
+  // Catch up with counters that may raise an interrupt.  Called
+  // between instruction batches.
+  void poll ()
+  {
+    if (armed)
+      update_interrupt ();
+  }
+
+  void checkpoint_state (checkpoint & c);
+
+private:
+
+  // PMCR bits.
+  static const uint32_t PMCR_E = 1 << 0;
+  static const uint32_t PMCR_P = 1 << 1;
+  static const uint32_t PMCR_C = 1 << 2;
+  static const uint32_t PMCR_D = 1 << 3;
+  static const uint32_t PMCR_WRITABLE = 0x3F;
+
+  // Implementer 'A', four counters.
+  static const uint32_t PMCR_ID = 0x41000000 | (N_COUNTERS << 11);
+
+  // Counter bits in the enable, overflow and interrupt registers.
+  static const unsigned CYCLE_COUNTER = N_COUNTERS;
+  static const uint32_t COUNTER_MASK = 0x80000000 | ((1 << N_COUNTERS) - 1);
+
+  struct counter
+  {
+    uint32_t value;		// As of the last update.
+    uint64_t base;		// Raw event total at the last update.
+    unsigned type;
+  };
+
+  tzic_module *tzic;
+
+  uint64_t events[N_EVENTS];
+
+  // The last one is the cycle counter.
+  counter counters[N_COUNTERS + 1];
+
+  uint32_t control;
+  uint32_t enabled;
+  uint32_t overflow;
+  uint32_t interrupts;
+  uint32_t selected;
+  uint32_t user_enable;
+
+  bool armed;
+  bool asserted;
+
+  static uint32_t bit (unsigned i)
+  {
+    return i == CYCLE_COUNTER ? 0x80000000 : 1 << i;
+  }
+
+  uint64_t raw (unsigned type) const;
+  bool running (unsigned i) const;
+  void settle (unsigned i);
+  void settle_all ();
+  void reconfigure (uint32_t new_control, uint32_t new_enabled);
+  void update_interrupt ();
+};
+
+#endif // !PMU_H.
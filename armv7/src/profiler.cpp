@@ -0,0 +1,179 @@
+// 'profiler.cpp' - Sampling profiler for guest code
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "profiler.h"
+#include "arm_interrupts.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+pc_profiler::pc_profiler (unsigned period):
+period (period ? period : 1), total (0), first (0), depth (0)
+{
+  countdown = this->period;
+}
+
+void
+pc_profiler::push (uint32_t entry, uint32_t ret)
+{
+  frame *f;
+
+  // Full: overwrite the oldest frame.
+  if (depth == MAX_DEPTH)
+    {
+      first = (first + 1) & (MAX_DEPTH - 1);
+      depth--;
+    }
+
+  depth++;
+  f = &top ();
+  f->entry = entry;
+  f->ret = ret;
+}
+
+void
+pc_profiler::call (uint32_t target, uint32_t ret)
+{
+  push (target, ret);
+}
+
+void
+pc_profiler::exception (uint32_t vector)
+{
+  push (vector, EXCEPTION_RET);
+}
+
+void
+pc_profiler::exception_return ()
+{
+  unsigned d;
+
+  // Handlers do not always return through their link address, so pop
+  // up to the latest exception frame.  Without one (it was dropped off
+  // the ring, or the exception predates profiling), leave the stack
+  // alone.
+  for (d = depth; d > 0; d--)
+    if (ring[(first + d - 1) & (MAX_DEPTH - 1)].ret == EXCEPTION_RET)
+      {
+	depth = d - 1;
+	break;
+      }
+}
+
+void
+pc_profiler::sample (uint32_t pc, unsigned mode)
+{
+  std::vector < uint32_t > key;
+
+  countdown = period;
+  total++;
+  pcs[pc]++;
+  modes[mode]++;
+
+  key.reserve (depth + 2);
+  key.push_back (mode);
+  for (unsigned i = 0; i < depth; i++)
+    key.push_back (ring[(first + i) & (MAX_DEPTH - 1)].entry);
+  key.push_back (pc);
+  stacks[key]++;
+}
+
+static const char *
+mode_name (unsigned mode)
+{
+  arm_impl::processor_mode m;
+  const char *name;
+
+  m.mode = mode;
+  name = m.currentMode_str ();
+  return name ? name : "UNKNOWN";
+}
+
+static bool
+by_samples (const std::pair < std::string, uint64_t > &a,
+	    const std::pair < std::string, uint64_t > &b)
+{
+  return a.second > b.second;
+}
+
+int
+pc_profiler::write (const char *file, symbol_table & symbols)
+{
+  std::string folded_name = std::string (file) + ".folded";
+  std::map < std::string, uint64_t > functions;
+  std::vector < std::pair < std::string, uint64_t > > flat;
+  FILE *out, *folded;
+
+  out = fopen (file, "w");
+  if (out == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write profile %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  folded = fopen (folded_name.c_str (), "w");
+  if (folded == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write profile %s: %s\n",
+	       folded_name.c_str (), strerror (errno));
+      fclose (out);
+      return -1;
+    }
+
+  // Flat profile, per function.
+  for (std::map < uint32_t, uint64_t >::iterator it = pcs.begin ();
+       it != pcs.end (); ++it)
+    functions[symbols.name (it->first)] += it->second;
+
+  flat.assign (functions.begin (), functions.end ());
+  std::stable_sort (flat.begin (), flat.end (), by_samples);
+
+  fprintf (out, "# %llu samples, one every %u instructions\n",
+	   (unsigned long long) total, period);
+  for (std::map < unsigned, uint64_t >::iterator it = modes.begin ();
+       it != modes.end (); ++it)
+    fprintf (out, "# %-10s %6.2f%% %10llu\n", mode_name (it->first),
+	     100.0 * it->second / total, (unsigned long long) it->second);
+  fprintf (out, "#\n#  percent    samples  symbol\n");
+
+  for (size_t i = 0; i < flat.size (); i++)
+    fprintf (out, "%9.2f%% %10llu  %s\n", 100.0 * flat[i].second / total,
+	     (unsigned long long) flat[i].second, flat[i].first.c_str ());
+
+  // Collapsed stacks: "mode;caller;...;leaf count".
+  for (std::map < std::vector < uint32_t >, uint64_t >::iterator it =
+       stacks.begin (); it != stacks.end (); ++it)
+    {
+      const std::vector < uint32_t > &key = it->first;
+
+      fputs (mode_name (key[0]), folded);
+      for (size_t i = 1; i < key.size (); i++)
+	fprintf (folded, ";%s", symbols.name (key[i]).c_str ());
+      fprintf (folded, " %llu\n", (unsigned long long) it->second);
+    }
+
+  fclose (out);
+  fclose (folded);
+
+  fprintf (stderr, "ArchC: Profile written to %s and %s\n", file,
+	   folded_name.c_str ());
+  return 0;
+}
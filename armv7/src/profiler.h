@@ -0,0 +1,108 @@
+// 'profiler.h' - Sampling profiler for guest code
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "symtab.h"
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+// Every PERIOD instructions, the profiler records the guest PC, the
+// processor mode and a shadow call stack built from BL/BLX and the
+// returns to their link addresses.  Exceptions push a frame for their
+// vector, and exception returns drop it along with whatever the handler
+// left above it.  At exit, samples are resolved
+// against a symbol table and written as a flat profile and as
+// collapsed stacks, the input format of flamegraph.pl.
+class pc_profiler
+{
+public:
+
+  // A prime, so samples do not lock step with guest loops.
+  static const unsigned DEFAULT_PERIOD = 997;
+
+  // Deepest shadow stack kept.  Older frames are dropped.  A power of
+  // two, since the stack is a ring.
+  static const unsigned MAX_DEPTH = 128;
+
+  pc_profiler (unsigned period = DEFAULT_PERIOD);
+
+  // Called before each instruction.
+  void step (uint32_t pc, unsigned mode)
+  {
+    if (depth && pc == top ().ret)
+      depth--;
+
+    if (--countdown == 0)
+      sample (pc, mode);
+  }
+
+  // The core branched and linked to TARGET, to come back to RET.
+  void call (uint32_t target, uint32_t ret);
+
+  // The core took an exception through VECTOR.
+  void exception (uint32_t vector);
+
+  // The core returned from an exception (SPSR copied to CPSR).
+  void exception_return ();
+
+  // Write the flat profile to FILE and collapsed stacks to FILE.folded,
+  // naming addresses after SYMBOLS.  Returns 0 on success and -1 on
+  // failure.
+  int write (const char *file, symbol_table & symbols);
+
+private:
+
+  struct frame
+  {
+    uint32_t entry;
+    uint32_t ret;
+  };
+
+  // Return address of exception frames.  Instructions are aligned, so
+  // no PC ever matches it.
+  static const uint32_t EXCEPTION_RET = 1;
+
+  unsigned period;
+  unsigned countdown;
+  uint64_t total;
+
+  // Shadow stack, DEPTH frames ending before ring[FIRST + DEPTH].
+  frame ring[MAX_DEPTH];
+  unsigned first;
+  unsigned depth;
+
+  frame & top ()
+  {
+    return ring[(first + depth - 1) & (MAX_DEPTH - 1)];
+  }
+
+  void push (uint32_t entry, uint32_t ret);
+
+  // Samples per PC, per mode and per call stack.  Stack keys are the
+  // mode, the entry of each frame and the sampled PC.
+  std::map < uint32_t, uint64_t > pcs;
+  std::map < unsigned, uint64_t > modes;
+  std::map < std::vector < uint32_t >, uint64_t > stacks;
+
+  void sample (uint32_t pc, unsigned mode);
+};
+
+#endif // !PROFILER_H.
@@ -0,0 +1,112 @@
+// 'quantum.h' - Temporal decoupling of the ARM core
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef QUANTUM_H
+#define QUANTUM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <systemc.h>
+#include "host_profile.h"
+
+// Quantum keeper in the spirit of the TLM-2.0 one.  The core keeps a
+// local time offset ahead of the SystemC kernel and only yields to it
+// once the offset reaches the global quantum, or when it is about to
+// talk to a device that must see the current time.  A quantum of 1ns
+// gives the original lock-step behavior.
+class quantum_keeper
+{
+public:
+
+  quantum_keeper ():
+  quantum (1), local (0), syncs (0), mid_instruction (false)
+  {
+  }
+
+  void set_global_quantum (uint64_t ns)
+  {
+    quantum = ns ? ns : 1;
+  }
+
+  uint64_t get_global_quantum () const
+  {
+    return quantum;
+  }
+
+  // Advance the core local time by NS nanoseconds.
+  void inc (uint64_t ns)
+  {
+    local += ns;
+  }
+
+  uint64_t get_local_time () const
+  {
+    return local;
+  }
+
+  // Time as seen by the core.
+  sc_time get_current_time () const
+  {
+    return sc_time_stamp () + sc_time ((double) local, SC_NS);
+  }
+
+  bool need_sync () const
+  {
+    return local >= quantum;
+  }
+
+  // Let the rest of the platform catch up with the core.  Must be
+  // called from the core thread.  MID is true when the core is in the
+  // middle of an instruction, like for a device access.
+  void sync (bool mid = false)
+  {
+    if (local == 0)
+      return;
+
+    sc_time offset ((double) local, SC_NS);
+    local = 0;
+    syncs++;
+    mid_instruction = mid;
+    {
+      HOST_PROFILE_SCOPE (HP_SYSTEMC);
+      wait (offset);
+    }
+    mid_instruction = false;
+  }
+
+  // Whether the core is waiting in the middle of an instruction, so
+  // asynchronous exceptions must not be taken now.
+  bool in_instruction () const
+  {
+    return mid_instruction;
+  }
+
+  void print_stats (FILE * stream) const
+  {
+    fprintf (stream, "ArchC: Quantum: %llu ns, %llu synchronizations\n",
+	     (unsigned long long) quantum, (unsigned long long) syncs);
+  }
+
+private:
+
+  uint64_t quantum;
+  uint64_t local;
+  uint64_t syncs;
+  bool mid_instruction;
+};
+
+#endif // !QUANTUM_H.
@@ -22,10 +22,12 @@
 // ----------------------------------------------------------------------
 
 #include "ram.h"
+#include "history.h"
 #include "arm_interrupts.h"
 #include "defines.H"
 
 #include <string>
+#include <stdlib.h>
 extern bool DEBUG_RAM;
 #define dprintf(args...) if(DEBUG_RAM){fprintf(stderr,args);}
 
@@ -33,16 +35,49 @@ ram_module::ram_module (const sc_module_name name_, tzic_module & tzic_,
 			const uint32_t blockNumber_):
 sc_module (name_),
 tzic (tzic_),
-blockNumber (blockNumber_)
+blockNumber (blockNumber_),
+hist (NULL)
 {
-  /* Allocate memory space.  */
-  memory = new unsigned[blockNumber / 4];
+  /* Allocate memory space, in whole pages.  Pages never written must
+     read as zero: checkpoints only store the others.  calloc leaves
+     fresh pages to the kernel, so they cost nothing until touched.  */
+  pages = ((blockNumber / 4) * 4 + (1 << PAGE_SHIFT) - 1) >> PAGE_SHIFT;
+  memory = (unsigned *) calloc (pages << (PAGE_SHIFT - 2), sizeof (unsigned));
+  if (memory == NULL)
+    {
+      fprintf (stderr, "ArchC: Could not allocate %s\n", name ());
+      exit (1);
+    }
+  dirty = new unsigned char[(pages + 7) / 8];
+  memset (dirty, 0, (pages + 7) / 8);
+  touched = new unsigned char[(pages + 7) / 8];
+  memset (touched, 0, (pages + 7) / 8);
 }
 
 ram_module::~ram_module ()
 {
 
-  delete[]memory;
+  free (memory);
+  delete[]dirty;
+  delete[]touched;
+}
+
+void
+ram_module::first_write (uint32_t page)
+{
+  if (hist)
+    hist->page_written (this, page);
+  dirty[page >> 3] |= 1 << (page & 7);
+}
+
+void
+ram_module::clean ()
+{
+  const uint32_t bytes = (pages + 7) / 8;
+
+  for (uint32_t i = 0; i < bytes; i++)
+    touched[i] |= dirty[i];
+  memset (dirty, 0, bytes);
 }
 
 unsigned
@@ -61,6 +96,7 @@ ram_module::fast_write (unsigned address, unsigned datum, unsigned offset)
   dprintf ("WRITE to %s local address: 0x%X (offset: 0x%X) Content: 0x%X\n",
 	   this->name (), address, offset, datum);
 
+  touch (address);
 #ifdef UNALIGNED_ACCESS_SUPPORT
   *((unsigned *) (((char*)memory) + address)) = datum;
 #else
@@ -110,5 +146,89 @@ ram_module::populate (char *file, unsigned start_address)
       exit (1);
     }
   fclose (fd);
+
+  for (off_t i = 0; i < st.st_size; i += 1 << PAGE_SHIFT)
+    touch (start_address + i);
+  touch (start_address + st.st_size - 1);
   return 0;
 }
+
+int
+ram_module::write_block (uint32_t offset, const void *data, size_t size)
+{
+  if (size == 0)
+    return 0;
+  if ((uint64_t) offset + size > (uint64_t) pages << PAGE_SHIFT)
+    return -1;
+
+  // Pages are marked before they change, so the history still gets
+  // what they held.
+  for (uint64_t page = offset >> PAGE_SHIFT;
+       page <= ((uint64_t) offset + size - 1) >> PAGE_SHIFT; page++)
+    touch (page << PAGE_SHIFT);
+
+  if (data)
+    memcpy ((char *) memory + offset, data, size);
+  else
+    memset ((char *) memory + offset, 0, size);
+  return 0;
+}
+
+void
+ram_module::checkpoint_state (checkpoint & c)
+{
+  const uint32_t page_words = 1 << (PAGE_SHIFT - 2);
+  const uint32_t bytes = (pages + 7) / 8;
+
+  if (c.saving ())
+    {
+      for (uint32_t page = 0; page < pages; page++)
+	{
+	  unsigned *p = memory + page * page_words;
+	  uint32_t i = 0;
+
+	  // A delta must have the pages that became zero too.
+	  if (c.delta ())
+	    {
+	      if (dirty_p (page))
+		c.save_page (page << PAGE_SHIFT, p);
+	      continue;
+	    }
+
+	  if (!touched_p (page))
+	    continue;
+	  while (i < page_words && p[i] == 0)
+	    i++;
+	  if (i < page_words)
+	    c.save_page (page << PAGE_SHIFT, p);
+	}
+
+      clean ();
+      return;
+    }
+
+  uint32_t offset;
+  const void *data;
+
+  // Whatever was written before is gone, unless this goes on top of it.
+  if (!c.delta ())
+    {
+      for (uint32_t page = 0; page < pages; page++)
+	if (touched_p (page))
+	  memset (memory + page * page_words, 0, 1 << PAGE_SHIFT);
+      memset (touched, 0, bytes);
+    }
+  memset (dirty, 0, bytes);
+
+  while (c.restore_page (&offset, &data))
+    {
+      if ((offset >> PAGE_SHIFT) >= pages
+	  || (offset & ((1 << PAGE_SHIFT) - 1)) != 0)
+	{
+	  c.mismatch ();
+	  return;
+	}
+      memcpy (memory + offset / 4, data, 1 << PAGE_SHIFT);
+      touched[offset >> (PAGE_SHIFT + 3)] |= 1 << ((offset >> PAGE_SHIFT) & 7);
+    }
+}
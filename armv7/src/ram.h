@@ -28,14 +28,49 @@
 #include <systemc.h>
 #include <ac_tlm_protocol.H>
 #include "tzic.h"
+#include "checkpoint.h"
 
-class ram_module:public sc_module, public peripheral
+class history;
+
+class ram_module:public sc_module, public peripheral, public checkpointable
 {
 private:
   tzic_module & tzic;
   unsigned *memory;
   uint32_t blockNumber;		//In Bytes
 
+  // One bit per page written since the last checkpoint, and one per
+  // page written before it, so checkpoints don't have to look at the
+  // whole memory and deltas only look at what changed.  Writes only
+  // mark DIRTY; checkpoints move it into TOUCHED.
+  static const unsigned PAGE_SHIFT = 12;
+  uint32_t pages;
+  unsigned char *dirty;
+  unsigned char *touched;
+
+  // Told about the first write to each page since the last checkpoint
+  // or snapshot, while it still holds what it held then.
+  history *hist;
+
+  void touch (unsigned address)
+  {
+    if (!dirty_p (address >> PAGE_SHIFT))
+      first_write (address >> PAGE_SHIFT);
+  }
+
+  void first_write (uint32_t page);
+
+  bool dirty_p (uint32_t page) const
+  {
+    return dirty[page >> 3] & (1 << (page & 7));
+  }
+
+  // Whether the page was ever written.
+  bool touched_p (uint32_t page) const
+  {
+    return (touched[page >> 3] | dirty[page >> 3]) & (1 << (page & 7));
+  }
+
   unsigned fast_read (unsigned address);
   void fast_write (unsigned address, unsigned datum, unsigned offset);
 
@@ -46,6 +81,38 @@ public:
 
   int populate (char *file, unsigned start_address);
 
+  // Copy SIZE bytes of DATA to OFFSET, or clear them if DATA is NULL,
+  // the way a write from the bus would.  Returns -1 if they don't fit.
+  int write_block (uint32_t offset, const void *data, size_t size);
+
+  // In bytes, which is a whole number of pages.
+  uint32_t size () const
+  {
+    return pages << PAGE_SHIFT;
+  }
+
+  // Pages that are not all zeros, or for deltas, pages written since
+  // the last checkpoint.
+  void checkpoint_state (checkpoint & c);
+
+  // Reverse execution.  The history is told about first writes, and
+  // gets pages back in place itself.
+  void set_history (history * h)
+  {
+    hist = h;
+  }
+
+  // Forget which pages were written, so the next write to each is a
+  // first one.
+  void clean ();
+
+  unsigned *page_data (uint32_t page)
+  {
+    return memory + (page << (PAGE_SHIFT - 2));
+  }
+
+  static const unsigned PAGE_SIZE = 1 << PAGE_SHIFT;
+
   // Wrapper read to implement peripheral interface with correct
   // parameters.
   unsigned read_signal (unsigned address, unsigned offset)
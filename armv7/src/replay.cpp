@@ -0,0 +1,267 @@
+// 'replay.cpp' - Console input record and replay
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "replay.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+host_input::host_input (const unsigned long long *instructions_):
+instructions (instructions_), mode (LIVE), file (NULL), queries (0),
+horizon (0), closed (false), log (NULL), logged (0), next (0), diverged (false)
+{
+}
+
+host_input::~host_input ()
+{
+  if (log != NULL)
+    fclose (log);
+}
+
+int
+host_input::record (const char *file_)
+{
+  struct replay_header header;
+
+  log = fopen (file_, "wb");
+  if (log == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to record input to %s: %s\n", file_,
+	       strerror (errno));
+      return -1;
+    }
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE);
+  if (fwrite (&header, sizeof (header), 1, log) != 1 || fflush (log) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to record input to %s: %s\n", file_,
+	       strerror (errno));
+      fclose (log);
+      log = NULL;
+      return -1;
+    }
+
+  file = file_;
+  mode = RECORD;
+  return 0;
+}
+
+int
+host_input::replay (const char *file_)
+{
+  struct replay_header header;
+  struct replay_event e;
+  FILE *f = fopen (file_, "rb");
+
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file_,
+	       strerror (errno));
+      return -1;
+    }
+
+  if (fread (&header, sizeof (header), 1, f) != 1
+      || memcmp (header.magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE) != 0)
+    {
+      fprintf (stderr, "ArchC: %s is not an input log\n", file_);
+      fclose (f);
+      return -1;
+    }
+
+  // A run that crashed may have left half an event at the end.
+  while (fread (&e, sizeof (e), 1, f) == 1)
+    events.push_back (e);
+  fclose (f);
+
+  file = file_;
+  mode = REPLAY;
+  return 0;
+}
+
+static bool
+earlier (const struct replay_event &a, const struct replay_event &b)
+{
+  return a.query < b.query;
+}
+
+bool
+host_input::host_pending ()
+{
+  struct timeval tv = { 0L, 0L };
+  fd_set rdset;
+
+  if (closed)
+    return false;
+  FD_ZERO (&rdset);
+  FD_SET (STDIN_FILENO, &rdset);
+  return select (STDIN_FILENO + 1, &rdset, NULL, NULL, &tv) == 1;
+}
+
+// Keep the answer the host gave to this question.
+void
+host_input::add_event (uint32_t kind, uint32_t data)
+{
+  struct replay_event e;
+
+  e.query = queries;
+  e.instructions = *instructions;
+  e.kind = kind;
+  e.data = data;
+  events.push_back (e);
+  next = events.size ();
+
+  if (mode == RECORD)
+    write_event (e);
+}
+
+void
+host_input::write_event (const struct replay_event &e)
+{
+  // Flushed right away, so the log survives whatever the run ends in.
+  if (fwrite (&e, sizeof (e), 1, log) != 1 || fflush (log) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to record input to %s: %s\n", file,
+	       strerror (errno));
+      fclose (log);
+      log = NULL;
+      mode = LIVE;
+      return;
+    }
+  logged++;
+}
+
+// Give back the recorded answer to this question, if it wasn't
+// "nothing".
+bool
+host_input::answer (uint32_t kind, uint32_t * data)
+{
+  uint64_t query = queries++;
+  const struct replay_event *e;
+
+  while (next < events.size () && events[next].query < query)
+    {
+      diverged = true;
+      next++;
+    }
+  if (next == events.size () || events[next].query != query)
+    return false;
+
+  e = &events[next++];
+  if ((e->kind != kind || e->instructions != *instructions) && !diverged)
+    {
+      fprintf (stderr, "ArchC: Input replay diverged after %llu "
+	       "instructions, it was recorded after %llu\n",
+	       (unsigned long long) *instructions,
+	       (unsigned long long) e->instructions);
+      diverged = true;
+    }
+  if (e->kind != kind)
+    return false;
+
+  *data = e->data;
+  return true;
+}
+
+bool
+host_input::pending ()
+{
+  uint32_t data;
+  bool ret;
+
+  if (from_log ())
+    return answer (REPLAY_PENDING, &data);
+
+  ret = host_pending ();
+  if (ret)
+    add_event (REPLAY_PENDING, 0);
+  horizon = ++queries;
+  return ret;
+}
+
+bool
+host_input::get (unsigned char *c)
+{
+  uint32_t data;
+  bool ret;
+
+  if (from_log ())
+    {
+      if (!answer (REPLAY_BYTE, &data))
+	return false;
+      *c = data;
+      return true;
+    }
+
+  ret = false;
+  if (host_pending ())
+    {
+      ssize_t n = read (STDIN_FILENO, c, 1);
+
+      // Past the end, stdin stays readable, but there's nothing to read.
+      if (n == 0)
+	closed = true;
+      ret = n == 1;
+    }
+  if (ret)
+    add_event (REPLAY_BYTE, *c);
+  horizon = ++queries;
+  return ret;
+}
+
+void
+host_input::detach ()
+{
+  if (log != NULL)
+    fclose (log);
+  log = NULL;
+  if (mode == RECORD)
+    mode = LIVE;
+  closed = true;
+}
+
+void
+host_input::print_stats (FILE * stream) const
+{
+  if (mode == RECORD)
+    fprintf (stream, "ArchC: Recorded %llu input events to %s\n",
+	     (unsigned long long) logged, file);
+  else if (mode == REPLAY)
+    fprintf (stream, "ArchC: Replayed %llu of %llu input events from %s%s\n",
+	     (unsigned long long) next, (unsigned long long) events.size (),
+	     file, diverged ? ", diverged" : "");
+}
+
+// Only where the questions are is saved.  The answers are in the input
+// log, or in memory.
+void
+host_input::checkpoint_state (checkpoint & c)
+{
+  struct replay_event e;
+
+  c.io (queries);
+  if (c.saving ())
+    return;
+
+  e.query = queries;
+  next = std::lower_bound (events.begin (), events.end (), e, earlier)
+    - events.begin ();
+  horizon = std::max (horizon, queries);
+}
@@ -0,0 +1,112 @@
+// 'replay.h' - Console input record and replay
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "checkpoint.h"
+#include "replay_format.h"
+
+// Console input, as seen by the UART.  Whether input is waiting, and
+// when, depends on the host, and is the only thing that does; the rest
+// of the platform runs the same every time on the same SystemC
+// schedule, interrupts included.  So a run can be recorded by logging
+// what the host said, with replay_format.h, and repeated exactly by
+// giving the same answers back instead of asking the host.
+//
+// Replay never touches stdin, so it doesn't wait for the host or need
+// a terminal.  Answers are checked against the instruction count they
+// were recorded at, to catch runs that went another way.
+//
+// Answers are kept in memory even when not recording, so a run brought
+// back to an earlier point goes forward the same way it went the first
+// time, until it catches up with where it had been.
+class host_input:public checkpointable
+{
+public:
+
+  // INSTRUCTIONS is the core instruction counter.
+  host_input (const unsigned long long *instructions);
+  ~host_input ();
+
+  // Both return 0 on success and -1 on failure.
+  int record (const char *file);
+  int replay (const char *file);
+
+  bool replaying () const
+  {
+    return mode == REPLAY;
+  }
+
+  // Whether there is input waiting.
+  bool pending ();
+
+  // Read one byte of input into C, if there is one.
+  bool get (unsigned char *c);
+
+  // Stop reading stdin and recording, for a forked process that must
+  // leave both to its parent.  Input already seen is still given back.
+  void detach ();
+
+  void print_stats (FILE * stream) const;
+
+  void checkpoint_state (checkpoint & c);
+
+private:
+
+  enum mode_t
+  {
+    LIVE, RECORD, REPLAY
+  };
+
+  const unsigned long long *instructions;
+  mode_t mode;
+  const char *file;
+
+  // Questions asked so far, and the most ever asked.  Questions below
+  // the horizon were asked before, and get the same answers.
+  uint64_t queries;
+  uint64_t horizon;
+
+  // Whether stdin reached its end.
+  bool closed;
+
+  // Recording.
+  FILE *log;
+  uint64_t logged;
+
+  // Answers that weren't "nothing", and the next one to give back.
+  std::vector < struct replay_event >events;
+  size_t next;
+  bool diverged;
+
+  bool from_log () const
+  {
+    return mode == REPLAY || queries < horizon;
+  }
+
+  bool host_pending ();
+  bool answer (uint32_t kind, uint32_t * data);
+  void add_event (uint32_t kind, uint32_t data);
+  void write_event (const struct replay_event &e);
+};
+
+#endif // !REPLAY_H.
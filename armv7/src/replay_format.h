@@ -0,0 +1,54 @@
+// 'replay_format.h' - Input log file format
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef REPLAY_FORMAT_H
+#define REPLAY_FORMAT_H
+
+#include <stdint.h>
+
+// An input log holds what the host answered every time the platform
+// asked it for console input, so a run can be repeated exactly:
+//
+//   struct replay_header
+//   struct replay_event [...]
+//
+// The platform asks at the same points of every run that got the same
+// answers, so questions are simply numbered, and only the ones that
+// didn't get "nothing" are logged.  Events are in question order, and
+// the log ends where the data ends.  All fields are little-endian.
+
+#define REPLAY_MAGIC "ARMRPL\0\1"
+#define REPLAY_MAGIC_SIZE 8
+
+// Event kinds.
+#define REPLAY_PENDING 0	// There was input waiting.
+#define REPLAY_BYTE 1		// data: the byte read.
+
+struct replay_header
+{
+  char magic[REPLAY_MAGIC_SIZE];
+};
+
+struct replay_event
+{
+  uint64_t query;		// Question number, from zero.
+  uint64_t instructions;	// Executed when it was asked.
+  uint32_t kind;
+  uint32_t data;
+};
+
+#endif // !REPLAY_FORMAT_H.
@@ -58,6 +58,9 @@ private:
   tzic_module & tzic;
   void *data;
 
+  // Mapped without boot code, as large as the ROM is on the bus.
+  static const size_t BLANK_SIZE = 0x100000;
+
   // Fast read/write don't implement error checking. The bus (or other caller)
   // must ensure the address is valid.
   // Invalid read/writes are treated as no-ops.
@@ -81,10 +84,19 @@ public:
 	      const char *dataPath):sc_module (name_), tzic (tzic_)
   {
 
+    // Kernels booted directly never run the boot code, but the ROM
+    // is still on the bus.
     if (!dataPath)
       {
-        printf ("ArchC: You must provide a boot code.\n");
-        exit (1);
+	printf ("ArchC: No boot code, the boot ROM reads as zeros.\n");
+	data = mmap (NULL, BLANK_SIZE, PROT_READ,
+		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (data == MAP_FAILED)
+	  {
+	    printf ("Unable to map a blank boot ROM\n");
+	    exit (1);
+	  }
+	return;
       }
 
     printf ("ArchC: Reading flat binary file: %s\n", dataPath);
@@ -0,0 +1,334 @@
+// 'sampling.cpp' - Sampled simulation in forked processes
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "sampling.h"
+#include "sd.h"
+#include "trace.h"
+#include "replay.h"
+#include "checkpoint.h"
+#include "throughput.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+
+extern memory_hierarchy *caches;
+extern trace_recorder *tracer;
+extern host_input *inputs;
+extern checkpoint *ckpt;
+extern throughput_meter *meter;
+
+static const char *const LEVEL_NAMES[memory_hierarchy::LEVELS] =
+  { "L1I", "L1D", "L2" };
+
+sampler::sampler (uint64_t warmup_, uint64_t window_, unsigned jobs_):
+warmup (warmup_), window (window_), jobs (jobs_), every (0), next (~0ULL),
+models (NULL), trace_file (NULL), trace_ring (0), trace_names (NULL),
+trace_n_names (0), card (NULL), running (0), taken (0), failed (0),
+windows (0), measured (0), number (0), measuring (false), first (0)
+{
+  fds[0] = fds[1] = -1;
+  memset (totals, 0, sizeof (totals));
+  memset (mpki, 0, sizeof (mpki));
+  memset (mpki_squares, 0, sizeof (mpki_squares));
+}
+
+sampler::~sampler ()
+{
+  if (fds[0] != -1)
+    close (fds[0]);
+  if (fds[1] != -1)
+    close (fds[1]);
+  delete models;
+}
+
+void
+sampler::set_points (uint64_t every_, const std::vector < uint64_t > &points_)
+{
+  every = every_;
+  points = points_;
+  std::sort (points.begin (), points.end ());
+}
+
+void
+sampler::set_caches (memory_hierarchy * caches_)
+{
+  models = caches_;
+}
+
+void
+sampler::set_trace (const char *file, uint64_t ring_records,
+		    const char *const *names, unsigned n_names)
+{
+  trace_file = file;
+  trace_ring = ring_records;
+  trace_names = names;
+  trace_n_names = n_names;
+}
+
+void
+sampler::set_sd_card (sd_card * card_)
+{
+  card = card_;
+}
+
+int
+sampler::start (uint64_t instructions)
+{
+  if (pipe (fds) != 0 || fcntl (fds[0], F_SETFL, O_NONBLOCK) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to set up sampling: %s\n",
+	       strerror (errno));
+      return -1;
+    }
+
+  schedule (instructions);
+  if (std::binary_search (points.begin (), points.end (), instructions))
+    next = instructions;
+  return 0;
+}
+
+// Find the first window start after INSTRUCTIONS.
+void
+sampler::schedule (uint64_t instructions)
+{
+  std::vector < uint64_t >::iterator p =
+    std::upper_bound (points.begin (), points.end (), instructions);
+
+  next = ~0ULL;
+  if (every != 0)
+    next = (instructions / every + 1) * every;
+  if (p != points.end ())
+    next = std::min (next, *p);
+}
+
+void
+sampler::advance (uint64_t instructions)
+{
+  if (number == 0)
+    fork_window (instructions);
+  else if (!measuring)
+    begin (instructions);
+  else
+    report (instructions);
+}
+
+void
+sampler::fork_window (uint64_t instructions)
+{
+  pid_t pid;
+
+  schedule (instructions);
+
+  collect (false);
+  while (running >= jobs)
+    collect (true);
+
+  // Or the child would print what was buffered again.
+  fflush (stdout);
+  fflush (stderr);
+
+  pid = fork ();
+  if (pid < 0)
+    {
+      fprintf (stderr, "ArchC: Unable to start a sample window: %s\n",
+	       strerror (errno));
+      failed++;
+      return;
+    }
+
+  taken++;
+  if (pid > 0)
+    running++;
+  else
+    enter_window (instructions);
+}
+
+// Child side of the fork.
+void
+sampler::enter_window (uint64_t instructions)
+{
+  int null = open ("/dev/null", O_WRONLY);
+
+  number = taken;
+  close (fds[0]);
+  fds[0] = -1;
+
+  // The console, and everything else with effects outside the process,
+  // belongs to the parent.
+  if (null != -1)
+    {
+      dup2 (null, STDOUT_FILENO);
+      close (null);
+    }
+  inputs->detach ();
+  if (card)
+    card->keep_writes_private ();
+  ckpt->set_periodic (NULL, 0);
+  meter->set_progress (0, NULL);
+
+  caches = models;
+  if (warmup == 0)
+    begin (instructions);
+  else
+    next = instructions + warmup;
+}
+
+void
+sampler::begin (uint64_t instructions)
+{
+  if (caches)
+    caches->reset_stats ();
+
+  if (trace_file)
+    {
+      char file[4096];
+
+      snprintf (file, sizeof (file), "%s.%u", trace_file, number);
+      tracer = new trace_recorder ();
+      if (tracer->open (file, trace_ring, trace_names, trace_n_names) != 0)
+	_exit (1);
+    }
+
+  measuring = true;
+  first = instructions;
+  next = instructions + window;
+}
+
+// Send the window to the parent and go away.
+void
+sampler::report (uint64_t instructions)
+{
+  result r;
+
+  memset (&r, 0, sizeof (r));
+  r.start = first;
+  r.instructions = measuring ? instructions - first : 0;
+  for (unsigned i = 0; caches && i < memory_hierarchy::LEVELS; i++)
+    {
+      cache_level *l = caches->level (i);
+
+      if (l == NULL)
+	continue;
+      r.counts[i][0] = l->reads;
+      r.counts[i][1] = l->read_misses;
+      r.counts[i][2] = l->writes;
+      r.counts[i][3] = l->write_misses;
+      r.counts[i][4] = l->writebacks;
+    }
+
+  if (tracer)
+    tracer->close ();
+
+  // Nothing else to clean up.  The rest is the parent's.
+  _exit (write (fds[1], &r, sizeof (r)) == sizeof (r) ? 0 : 1);
+}
+
+// Reap finished children and take their results.
+void
+sampler::collect (bool block)
+{
+  result r;
+  int status;
+  pid_t pid;
+
+  while (running > 0
+	 && (pid = waitpid (-1, &status, block ? 0 : WNOHANG)) > 0)
+    {
+      running--;
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+	failed++;
+      block = false;
+    }
+
+  while (read (fds[0], &r, sizeof (r)) == sizeof (r))
+    add (r);
+}
+
+void
+sampler::add (const result & r)
+{
+  // The run ended before the window did.
+  if (r.instructions == 0)
+    return;
+
+  windows++;
+  measured += r.instructions;
+
+  for (unsigned i = 0; i < memory_hierarchy::LEVELS; i++)
+    {
+      double m;
+
+      for (unsigned j = 0; j < 5; j++)
+	totals[i][j] += r.counts[i][j];
+      m = 1000.0 * (r.counts[i][1] + r.counts[i][3]) / r.instructions;
+      mpki[i] += m;
+      mpki_squares[i] += m * m;
+    }
+}
+
+void
+sampler::finish (uint64_t instructions)
+{
+  if (number != 0)
+    report (instructions);
+
+  while (running > 0)
+    collect (true);
+  collect (false);
+}
+
+void
+sampler::print_stats (FILE * stream)
+{
+  fprintf (stream, "ArchC: Sampled %u windows of %llu instructions after "
+	   "%llu of warm-up, %llu instructions measured\n", windows,
+	   (unsigned long long) window, (unsigned long long) warmup,
+	   (unsigned long long) measured);
+  if (failed)
+    fprintf (stream, "ArchC: %u sample windows failed\n", failed);
+
+  if (models == NULL || windows == 0)
+    return;
+
+  // Print the sums the way a run with the caches on all along would.
+  for (unsigned i = 0; i < memory_hierarchy::LEVELS; i++)
+    {
+      cache_level *l = models->level (i);
+      double mean, variance;
+
+      if (l == NULL)
+	continue;
+      l->reads = totals[i][0];
+      l->read_misses = totals[i][1];
+      l->writes = totals[i][2];
+      l->write_misses = totals[i][3];
+      l->writebacks = totals[i][4];
+      l->print_stats (stream);
+
+      mean = mpki[i] / windows;
+      variance = windows > 1
+	? (mpki_squares[i] - windows * mean * mean) / (windows - 1) : 0;
+      fprintf (stream, "ArchC: %-4s %.3f misses per 1000 instructions, "
+	       "+- %.3f (95%% confidence)\n", LEVEL_NAMES[i], mean,
+	       1.96 * sqrt (std::max (variance, 0.0) / windows));
+    }
+}
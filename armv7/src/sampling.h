@@ -0,0 +1,136 @@
+// 'sampling.h' - Sampled simulation in forked processes
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "cache.h"
+
+class sd_card;
+
+// Sampled simulation of long runs.  The run goes on functionally,
+// without the cache model or the trace, and forks at chosen instruction
+// counts.  Each child warms the caches up for WARMUP instructions,
+// measures the next WINDOW, reports to its parent through a pipe and
+// exits, while the parent keeps going.  Children get a copy-on-write
+// copy of the whole platform, guest memory included, so up to JOBS of
+// them run on other host cores for little more than the cost of their
+// own instructions.  In the end, the parent adds all windows up.
+//
+// Children leave alone what belongs to their parent: the console, the
+// input log, the SD overlay file, checkpoints and progress reports.
+// Window N traces to <trace>.N.
+class sampler
+{
+public:
+
+  sampler (uint64_t warmup, uint64_t window, unsigned jobs);
+  ~sampler ();
+
+  // Windows start every EVERY instructions, if it is not zero, and at
+  // each of POINTS.
+  void set_points (uint64_t every, const std::vector < uint64_t > &points);
+
+  // The detailed models, only brought up in windows.  CACHES is owned
+  // from now on.
+  void set_caches (memory_hierarchy * caches);
+  void set_trace (const char *file, uint64_t ring_records,
+		  const char *const *names, unsigned n_names);
+  void set_sd_card (sd_card * card);
+
+  // Returns 0 on success and -1 on failure.
+  int start (uint64_t instructions);
+
+  // Called between instruction batches.
+  void poll (uint64_t instructions)
+  {
+    if (instructions < next)
+      return;
+    advance (instructions);
+  }
+
+  // The simulation is over.  A child reports its window so far and
+  // exits; the parent waits for every child.
+  void finish (uint64_t instructions);
+
+  void print_stats (FILE * stream);
+
+private:
+
+  // Sent from each child to its parent, in one write, so it can't mix
+  // with another child's.
+  struct result
+  {
+    uint64_t start;
+    uint64_t instructions;
+
+    // Per memory_hierarchy level: reads, read misses, writes, write
+    // misses and write-backs.
+    uint64_t counts[memory_hierarchy::LEVELS][5];
+  };
+
+  uint64_t warmup;
+  uint64_t window;
+  unsigned jobs;
+
+  uint64_t every;
+  std::vector < uint64_t > points;
+  uint64_t next;
+
+  memory_hierarchy *models;
+  const char *trace_file;
+  uint64_t trace_ring;
+  const char *const *trace_names;
+  unsigned trace_n_names;
+  sd_card *card;
+
+  // Pipe from children to the parent.
+  int fds[2];
+
+  // Parent.
+  unsigned running;
+  unsigned taken;
+  unsigned failed;
+  unsigned windows;
+  uint64_t measured;
+  uint64_t totals[memory_hierarchy::LEVELS][5];
+
+  // Misses per thousand instructions of each window, summed and
+  // squared, for confidence intervals.
+  double mpki[memory_hierarchy::LEVELS];
+  double mpki_squares[memory_hierarchy::LEVELS];
+
+  // Child, with its window number, and where measuring started.
+  unsigned number;
+  bool measuring;
+  uint64_t first;
+
+  void advance (uint64_t instructions);
+  void schedule (uint64_t instructions);
+  void fork_window (uint64_t instructions);
+  void enter_window (uint64_t instructions);
+  void begin (uint64_t instructions);
+  void report (uint64_t instructions);
+  void collect (bool block);
+  void add (const result & r);
+};
+
+#endif // !SAMPLING_H.
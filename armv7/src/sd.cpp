@@ -22,7 +22,9 @@
 // ----------------------------------------------------------------------
 
 #include "sd.h"
+#include "host_profile.h"
 #include <errno.h>
+#include <algorithm>
 
 extern bool DEBUG_SD;
 #define dprintf(args...) if(DEBUG_SD){fprintf(stderr,args);}
@@ -43,7 +45,8 @@ const char sd_card::CID[] = { 0x02, 0x54, 0x4d, 0x53,
 const char sd_card::SCR[] = { 0x02, 0x35, 0x80, 0x00,
                               0x01, 0x00, 0x00, 0x00 };
 
-sd_card::sd_card (sc_module_name name_, const char *file):
+sd_card::sd_card (sc_module_name name_, const char *file,
+                  const char *overlay_file, bool discard_overlay):
 sc_module (name_)
 {
   //*command_handler[0] = cmd0_handler;
@@ -53,6 +56,20 @@ sc_module (name_)
       exit (1);
     }
 
+  if (overlay.open (overlay_file, data_size, discard_overlay) != 0)
+    {
+      exit (1);
+    }
+  image_file = strdup (file);
+
+  // Default block length, until the host issues a CMD16.
+  this->blocklen = 512;
+
+  this->current_block = 0;
+  this->readahead_blocks = 0;
+  this->sequential_p = false;
+  this->readahead_end = 0;
+
   // Set current state to idle.
   this->current_state = SD_IDLE;
 
@@ -75,17 +92,45 @@ sc_module (name_)
 
 sd_card::~sd_card ()
 {
+  if (zimage)
+    {
+      zimage->print_stats (stderr);
+      delete zimage;
+    }
   //munmap: free data allocated by mmap
-  if (munmap (data, data_size) != 0)
+  else if (munmap (data, data_size) != 0)
     {
       fprintf (stderr, "%s: Unable to free SD mmapped memory", this->name ());
     }
+  free (image_file);
+}
+
+int
+sd_card::commit_overlay ()
+{
+  if (zimage)
+    {
+      fprintf (stderr, "%s: Cannot commit changes to compressed image %s\n",
+	       this->name (), image_file);
+      return -1;
+    }
+  return overlay.commit (image_file);
+}
+
+void
+sd_card::set_cache_size (size_t bytes)
+{
+  if (zimage)
+    zimage->set_cache_size (bytes);
 }
 
 // Load a given binary image from disk to SD_card memory backend.  It
 // attemps to mmap file passed as argument to data pointer.  On success
 // defines data_size and returns 0. On failure returns -1.
 // data pointes must be unmapped when no longer needed.
+//
+// The image is mapped read-only and shared, so concurrent simulations
+// may use the same file.  Guest writes are kept in the overlay.
 int
 sd_card::load_image_from_file (const char *file)
 {
@@ -102,7 +147,21 @@ sd_card::load_image_from_file (const char *file)
   fprintf (stderr, "ArchC: %s: Loading SD card file: %s\n",
 	   this->name (), file);
 
-  dataFile = open (file, O_LARGEFILE);
+  this->zimage = NULL;
+  this->data = NULL;
+
+  // Compressed images are not mapped, chunks are inflated on demand.
+  if (sd_compressed_image::is_compressed (file))
+    {
+      zimage = new sd_compressed_image ();
+      if (zimage->open (file) != 0)
+	return -1;
+
+      this->data_size = zimage->size ();
+      return 0;
+    }
+
+  dataFile = open (file, O_RDONLY | O_LARGEFILE);
   if (dataFile == -1)
     {
       fprintf (stderr, "%s: Unable to load file %s: Error: %s",
@@ -113,8 +172,7 @@ sd_card::load_image_from_file (const char *file)
   stat (file, &st);
   this->data_size = st.st_size;
 
-  this->data = mmap (NULL, data_size, PROT_READ | PROT_WRITE,
-		     MAP_PRIVATE, dataFile, 0);
+  this->data = mmap (NULL, data_size, PROT_READ, MAP_SHARED, dataFile, 0);
 
   if (data == MAP_FAILED)
     {
@@ -134,8 +192,13 @@ sd_card::prc_sdcard ()
 {
   do
     {
-      wait (1, SC_NS);
+      // Only data transfer states do work on their own.
+      if (busy_p ())
+	wait (1, SC_NS);
+      else
+	wait (transfer_started);
 
+      HOST_PROFILE_SCOPE (HP_SDCARD);
       if (current_state == SD_IDLE)
 	continue;
 
@@ -147,6 +210,12 @@ sd_card::prc_sdcard ()
 	case SD_DATA:
 	  exec_state_data ();
 	  break;
+	case SD_RCV:
+	  exec_state_rcv ();
+	  break;
+	case SD_PRG:
+	  exec_state_prg ();
+	  break;
         case SD_READY:
         case SD_IDENT:
         case SD_STBY:
@@ -175,15 +244,193 @@ sd_card::exec_state_data ()
 
   // Send next block to dataline.
 
-  memcpy (data_line, &( ((char *) data)[current_block*blocklen]), blocklen);
+  read_image ((uint64_t) current_block * blocklen, data_line, blocklen);
   current_block += 1;
   data_line_busy = true;
 
+  read_ahead ();
+
   //If single read, stop it
   if (single_block_p == true)
     update_state (SD_TRAN);
 }
 
+//  Current state RCV procedure.
+void
+sd_card::exec_state_rcv ()
+{
+  if (!data_line_busy)
+    return;			// Wait for the host to send a block.
+
+  dprintf ("%s: Block Write: Storing data to block 0x%x. blocklen=%d\n",
+	   this->name (), current_block, blocklen);
+
+  write_image ((uint64_t) current_block * blocklen, data_line, blocklen);
+  current_block += 1;
+  data_line_busy = false;
+
+  //If single write, program it.
+  if (single_block_p == true)
+    update_state (SD_PRG);
+}
+
+//  Current state PRG procedure.  Blocks are stored as soon as they
+//  arrive, so only a block received right before CMD12 is pending here.
+void
+sd_card::exec_state_prg ()
+{
+  if (data_line_busy)
+    {
+      write_image ((uint64_t) current_block * blocklen, data_line, blocklen);
+      current_block += 1;
+      data_line_busy = false;
+    }
+
+  update_state (card_selected_p ? SD_TRAN : SD_STBY);
+}
+
+// Read LEN bytes of the base image at OFFSET.
+void
+sd_card::read_base (uint64_t offset, unsigned char *buf, size_t len)
+{
+  if (zimage == NULL)
+    memcpy (buf, ((unsigned char *) data) + offset, len);
+  else if (zimage->read (offset, buf, len) != 0)
+    {
+      fprintf (stderr, "%s: Unable to read compressed image at 0x%llx\n",
+	       this->name (), (unsigned long long) offset);
+      exit (1);
+    }
+}
+
+// Prefetch a window of READAHEAD_BLOCKS after the current block.  The
+// window is refilled once half of it was consumed, so requests reach
+// the host kernel well before the data is needed.  Both madvise and
+// posix_fadvise return immediately.
+void
+sd_card::read_ahead ()
+{
+  uint64_t pos, window, start, end;
+
+  if (readahead_blocks == 0 || !sequential_p)
+    return;
+
+  pos = (uint64_t) current_block * blocklen;
+  window = (uint64_t) readahead_blocks * blocklen;
+
+  if (readahead_end > pos + window / 2)
+    return;
+
+  start = (readahead_end > pos) ? readahead_end : pos;
+  end = (pos + window < data_size) ? pos + window : data_size;
+  if (start >= end)
+    return;
+
+  dprintf ("%s: Read-ahead: 0x%llx-0x%llx\n", this->name (),
+	   (unsigned long long) start, (unsigned long long) end);
+
+  if (zimage)
+    zimage->prefetch (start, end - start);
+  else
+    {
+      uint64_t page = sysconf (_SC_PAGESIZE);
+      uint64_t aligned = start & ~(page - 1);
+
+      madvise (((char *) data) + aligned, end - aligned, MADV_WILLNEED);
+    }
+
+  readahead_end = end;
+}
+
+// Read LEN bytes of card contents at OFFSET.  Chunks written by the
+// guest come from the overlay, everything else from the base image.
+void
+sd_card::read_image (uint64_t offset, unsigned char *buf, size_t len)
+{
+  unsigned char chunk_buf[sd_overlay::CHUNK_SIZE];
+
+  if (offset + len > data_size)
+    {
+      fprintf (stderr, "%s: Access to 0x%llx beyond end of card\n",
+	       this->name (), (unsigned long long) offset);
+      exit (1);
+    }
+
+  while (len > 0)
+    {
+      uint64_t chunk = offset / sd_overlay::CHUNK_SIZE;
+      size_t skip = offset % sd_overlay::CHUNK_SIZE;
+      size_t n = sd_overlay::CHUNK_SIZE - skip;
+      if (n > len)
+	n = len;
+
+      if (overlay.is_dirty (chunk))
+	{
+	  if (overlay.read_chunk (chunk, chunk_buf) != 0)
+	    exit (1);
+	  memcpy (buf, chunk_buf + skip, n);
+	}
+      else
+	read_base (offset, buf, n);
+
+      buf += n;
+      offset += n;
+      len -= n;
+    }
+}
+
+// Write LEN bytes at OFFSET.  The first write to a chunk copies it from
+// the base image to the overlay.
+void
+sd_card::write_image (uint64_t offset, const unsigned char *buf, size_t len)
+{
+  unsigned char chunk_buf[sd_overlay::CHUNK_SIZE];
+
+  if (offset + len > data_size)
+    {
+      fprintf (stderr, "%s: Access to 0x%llx beyond end of card\n",
+	       this->name (), (unsigned long long) offset);
+      exit (1);
+    }
+
+  while (len > 0)
+    {
+      uint64_t chunk = offset / sd_overlay::CHUNK_SIZE;
+      uint64_t base = chunk * sd_overlay::CHUNK_SIZE;
+      size_t skip = offset % sd_overlay::CHUNK_SIZE;
+      size_t n = sd_overlay::CHUNK_SIZE - skip;
+      if (n > len)
+	n = len;
+
+      if (n < sd_overlay::CHUNK_SIZE)
+	{
+	  if (overlay.is_dirty (chunk))
+	    {
+	      if (overlay.read_chunk (chunk, chunk_buf) != 0)
+		exit (1);
+	    }
+	  else
+	    {
+	      // Last chunk of the image may be partial.
+	      size_t avail = data_size - base;
+	      if (avail > sd_overlay::CHUNK_SIZE)
+		avail = sd_overlay::CHUNK_SIZE;
+
+	      memset (chunk_buf, 0, sd_overlay::CHUNK_SIZE);
+	      read_base (base, chunk_buf, avail);
+	    }
+	}
+
+      memcpy (chunk_buf + skip, buf, n);
+      if (overlay.write_chunk (chunk, chunk_buf) != 0)
+	exit (1);
+
+      buf += n;
+      offset += n;
+      len -= n;
+    }
+}
+
 // This function is used by external controllers to read the sd card IO buffer
 // It doesn't check any data integrity.
 bool
@@ -200,6 +447,25 @@ sd_card::read_dataline (std::queue < unsigned char >&buffer, uint32_t len)
   return false;
 }
 
+// This function is used by external controllers to write to the sd card
+// IO buffer. It doesn't check any data integrity.
+bool
+sd_card::write_dataline (std::queue < unsigned char >&buffer, uint32_t len)
+{
+  if (current_state != SD_RCV || data_line_busy
+      || buffer.size () < (size_t) blocklen)
+    return false;
+
+  for (int i = 0; i < blocklen; i++)
+    {
+      data_line[i] = buffer.front ();
+      buffer.pop ();
+    }
+
+  data_line_busy = true;	//Dataline holds a block to be stored.
+  return true;
+}
+
 //  SD Specification commands Handlers
 struct sd_response
 sd_card::exec_cmd (short cmd_index, short cmd_type, uint32_t arg)
@@ -225,14 +491,18 @@ sd_card::exec_cmd (short cmd_index, short cmd_type, uint32_t arg)
 	  return cmd9_handler (arg);
 	case 12:
 	  return cmd12_handler (arg);
-          //   case 13:
-          //	  return cmd13_handler (arg);
+	case 13:
+	  return cmd13_handler (arg);
 	case 16:
 	  return cmd16_handler (arg);
 	case 17:
 	  return cmd17_handler (arg);
 	case 18:
 	  return cmd18_handler (arg);
+	case 24:
+	  return cmd24_handler (arg);
+	case 25:
+	  return cmd25_handler (arg);
 	case 55:
 	  return cmd55_handler (arg);
         case 43:
@@ -498,16 +768,18 @@ sd_card::cmd13_handler (uint32_t arg)
   // if (((arg & 0xFFFF0000) >> 16) != rca)
   //   return resp;
 
+  resp.type = R1;
+  memset (resp.response, 0, sizeof (resp.response));
+
   if ((current_state == SD_IDLE) || (current_state == SD_READY)
       || (current_state == SD_IDENT) || (current_state == SD_INA))
       return resp;
 
-  resp.response[0] = (0b11 << 6) | 13;
-  resp.response[1] = 0x0;
-  resp.response[2] = 0x0;
-  resp.response[3] = 0x0;
-  resp.response[4] = 0x0;
-  resp.response[4] = 0x1;
+  // Card status: CURRENT_STATE in bits 12:9 and READY_FOR_DATA in bit
+  // 8. sd_state follows the encoding of the specification.
+  resp.response[0] = 13;
+  resp.response[3] = ((current_state & 0xF) << 1)
+    | ((current_state == SD_PRG || data_line_busy) ? 0 : 1);
 
   return resp;
 }
@@ -548,6 +820,11 @@ sd_card::cmd17_handler (uint32_t arg)
 
   if (current_state == SD_TRAN)
     {
+      // Drivers often read big ranges block by block.
+      sequential_p = (arg == current_block);
+      if (!sequential_p)
+	readahead_end = 0;
+
       data_line_busy = false;
       current_block = arg;
       single_block_p = true;
@@ -567,6 +844,10 @@ sd_card::cmd18_handler (uint32_t arg)
 
   if (current_state == SD_TRAN)
     {
+      if (arg != current_block)
+	readahead_end = 0;
+      sequential_p = true;
+
       current_block = arg;
       single_block_p = false;
       update_state (SD_DATA);
@@ -574,6 +855,43 @@ sd_card::cmd18_handler (uint32_t arg)
   return resp;
 }
 
+// CMD24 ==>  WRITE_BLOCK
+struct sd_response
+sd_card::cmd24_handler (uint32_t arg)
+{
+  struct sd_response resp;
+  dprintf ("%s: CMD24: arg=0x%X\n", this->name (), arg);
+
+  resp.type = R1;
+  if (current_state == SD_TRAN)
+    {
+      data_line_busy = false;
+      current_block = arg;
+      single_block_p = true;
+      // Wait for data from host.
+      update_state (SD_RCV);
+    }
+  return resp;
+}
+
+// CMD25 ==>  WRITE_MULTIPLE_BLOCK
+struct sd_response
+sd_card::cmd25_handler (uint32_t arg)
+{
+  struct sd_response resp;
+  dprintf ("%s: CMD25: arg=0x%X\n", this->name (), arg);
+
+  resp.type = R1;
+  if (current_state == SD_TRAN)
+    {
+      data_line_busy = false;
+      current_block = arg;
+      single_block_p = false;
+      update_state (SD_RCV);
+    }
+  return resp;
+}
+
 // CMD55 ==> APP_CMD
 struct sd_response
 sd_card::cmd55_handler (uint32_t arg)
@@ -688,5 +1006,99 @@ sd_card::update_state (const enum sd_state new_state)
 	   state_to_string (new_state));
 
   current_state = new_state;
+
+  if (busy_p ())
+    transfer_started.notify (1, SC_NS);
 }
 
+
+void
+sd_card::checkpoint_state (checkpoint & c)
+{
+  unsigned char chunk_buf[sd_overlay::CHUNK_SIZE];
+  uint64_t size = data_size;
+  uint64_t n_dirty = 0, next;
+
+  c.io (size);
+  if (size != data_size)
+    {
+      c.mismatch ();
+      return;
+    }
+
+  c.io (current_state);
+  c.io (single_block_p);
+  c.io (application_specific_p);
+  c.io (blocklen);
+  c.io (current_block);
+  c.io (sequential_p);
+  c.io (readahead_end);
+  c.io (data_line);
+  c.io (rca);
+  c.io (card_selected_p);
+  c.io (bus_width);
+  c.io (data_line_busy);
+
+  // Dirty overlay chunks, as (chunk, data) in increasing order.
+  if (c.saving ())
+    {
+      for (uint64_t i = 0; i < overlay.chunks (); i++)
+	if (overlay.is_dirty (i))
+	  n_dirty++;
+      c.io (n_dirty);
+      for (uint64_t i = 0; i < overlay.chunks (); i++)
+	if (overlay.is_dirty (i))
+	  {
+	    if (overlay.read_chunk (i, chunk_buf) != 0)
+	      exit (1);
+	    c.io (i);
+	    c.io (chunk_buf);
+	  }
+      return;
+    }
+
+  // A named overlay may hold writes made after the checkpoint was
+  // taken.  Those chunks go back to the base image contents.
+  c.io (n_dirty);
+  next = 0;
+  for (uint64_t j = 0; j <= n_dirty; j++)
+    {
+      uint64_t chunk = overlay.chunks ();
+
+      if (j < n_dirty)
+	{
+	  c.io (chunk);
+	  c.io (chunk_buf);
+	  if (chunk < next || chunk >= overlay.chunks ())
+	    {
+	      c.mismatch ();
+	      return;
+	    }
+	}
+
+      for (; next < chunk; next++)
+	if (overlay.is_dirty (next))
+	  {
+	    uint64_t offset = next * sd_overlay::CHUNK_SIZE;
+	    unsigned char base[sd_overlay::CHUNK_SIZE];
+
+	    memset (base, 0, sizeof (base));
+	    read_base (offset, base,
+		       std::min ((uint64_t) sizeof (base), size - offset));
+	    if (overlay.write_chunk (next, base) != 0)
+	      exit (1);
+	  }
+
+      if (j < n_dirty)
+	{
+	  if (overlay.write_chunk (chunk, chunk_buf) != 0)
+	    exit (1);
+	  next = chunk + 1;
+	}
+    }
+
+  // The thread may be sleeping on an idle present while the restored
+  // card is busy.
+  if (busy_p ())
+    transfer_started.notify (1, SC_NS);
+}
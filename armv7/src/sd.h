@@ -26,6 +26,9 @@
 
 #include "peripheral.h"
 #include "tzic.h"
+#include "sd_overlay.h"
+#include "sd_compressed.h"
+#include "checkpoint.h"
 
 #include <sys/stat.h>
 #include <systemc.h>
@@ -51,7 +54,7 @@ struct sd_response
   unsigned char response[17];
 };
 
-class sd_card:public sc_module
+class sd_card:public sc_module, public checkpointable
 {
   enum sd_state
   {
@@ -82,24 +85,53 @@ private:
   // FSM state pointer
   enum sd_state current_state;
 
+  // Notified when the card enters a data transfer state.
+  sc_event transfer_started;
+
+  bool busy_p () const
+  {
+    return (current_state == SD_DATA || current_state == SD_RCV
+	    || current_state == SD_PRG);
+  }
+
   // Whether performing a single block operation.
   bool single_block_p;
 
   // Flag for treating next  command as application specific.
   bool application_specific_p;
 
-  // Main pointer to SD memory on RAM
+  // Main pointer to SD memory on RAM.  The base image is mapped
+  // read-only; every write goes to the overlay.
   void *data;
 
   // Size of SD card bin file
   size_t data_size;
 
+  // Backend for SDZ images.  NULL if the image is a raw one, mapped
+  // at data.
+  sd_compressed_image *zimage;
+
+  // Path of the base image, needed to commit the overlay.
+  char *image_file;
+
+  // Copy-on-write store for blocks written by the guest.
+  sd_overlay overlay;
+
   // Block Length defined by cmd16
   int blocklen;
 
   // Current accessed block
   uint32_t current_block;
 
+  // Read-ahead depth in blocks. 0 disables read-ahead.
+  unsigned readahead_blocks;
+
+  // Whether current read continues a sequential stream.
+  bool sequential_p;
+
+  // Image offset up to which read-ahead was already requested.
+  uint64_t readahead_end;
+
   // Data line buffer.
   unsigned char data_line[4096];
 
@@ -114,6 +146,19 @@ private:
 
   // -- States Handler --
   void exec_state_data ();
+  void exec_state_rcv ();
+  void exec_state_prg ();
+
+  // Read from the base image, whatever its format.
+  void read_base (uint64_t offset, unsigned char *buf, size_t len);
+
+  // Ask the host kernel to bring the next blocks of a sequential read
+  // to memory, so the simulation doesn't stall on disk I/O.
+  void read_ahead ();
+
+  // Byte-addressed access to card contents, through the overlay.
+  void read_image (uint64_t offset, unsigned char *buf, size_t len);
+  void write_image (uint64_t offset, const unsigned char *buf, size_t len);
 
   // Command Handlers
   struct sd_response cmd0_handler (uint32_t arg);	// Set card to Idle.
@@ -128,6 +173,8 @@ private:
   struct sd_response cmd16_handler (uint32_t arg);	// Set_BlockLen.
   struct sd_response cmd17_handler (uint32_t arg);	// Read Single Block.
   struct sd_response cmd18_handler (uint32_t arg);	// Read Multiple Block.
+  struct sd_response cmd24_handler (uint32_t arg);	// Write Single Block.
+  struct sd_response cmd25_handler (uint32_t arg);	// Write Multiple Block.
   struct sd_response cmd55_handler (uint32_t arg);	// Next cmd is application
 
   // Application command handler
@@ -146,17 +193,44 @@ public:
     SC_HAS_PROCESS (sd_card);
   void prc_sdcard ();
 
-    sd_card (sc_module_name name_, const char *file);
+    sd_card (sc_module_name name_, const char *file,
+             const char *overlay_file = NULL, bool discard_overlay = false);
    ~sd_card ();
 
+  // Write every block modified by the guest back to the base image.
+  int commit_overlay ();
+
+  // Keep guest writes in this process only.
+  void keep_writes_private ()
+  {
+    overlay.keep_private ();
+  }
+
+  // Bound the memory used to cache inflated chunks of an SDZ image.
+  void set_cache_size (size_t bytes);
+
+  // Number of blocks prefetched ahead of sequential reads.
+  void set_readahead (unsigned blocks)
+  {
+    readahead_blocks = blocks;
+  }
+
   struct sd_response exec_cmd (short cmd_index, short cmd_type, uint32_t arg);
 
   // This function is used by external controllers to read the sd card
   // IO buffer It doesn't check any data integrity.
   bool read_dataline (std::queue < unsigned char >&buffer, uint32_t len);
 
+  // Counterpart of read_dataline for write transfers.  Moves one block
+  // from BUFFER to the card if it is ready to receive it.
+  bool write_dataline (std::queue < unsigned char >&buffer, uint32_t len);
+
   // Semaphor for data_line
   bool data_line_busy;
+
+  // The card state and what the guest wrote to it.  The image itself
+  // must be the same when restoring.
+  void checkpoint_state (checkpoint & c);
 };
 
 #endif // !SD_H.
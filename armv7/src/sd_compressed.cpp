@@ -0,0 +1,260 @@
+// 'sd_compressed.cpp' - Backend for compressed SD card images
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "sd_compressed.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+extern bool DEBUG_SD;
+#define dprintf(args...) if(DEBUG_SD){fprintf(stderr,args);}
+
+sd_compressed_image::sd_compressed_image ():
+fd (-1), index (NULL), zbuf (NULL), zbuf_size (0),
+hits (0), misses (0), zero_reads (0)
+{
+  memset (&header, 0, sizeof (header));
+  max_entries = 1;
+}
+
+sd_compressed_image::~sd_compressed_image ()
+{
+  std::map < uint64_t, cache_entry >::iterator it;
+
+  for (it = cache.begin (); it != cache.end (); ++it)
+    free (it->second.data);
+
+  free (index);
+  free (zbuf);
+  if (fd != -1)
+    close (fd);
+}
+
+bool
+sd_compressed_image::is_compressed (const char *file)
+{
+  char magic[SDZ_MAGIC_SIZE];
+  int f = ::open (file, O_RDONLY | O_LARGEFILE);
+  bool ret;
+
+  if (f == -1)
+    return false;
+
+  ret = (pread (f, magic, SDZ_MAGIC_SIZE, 0) == SDZ_MAGIC_SIZE
+	 && memcmp (magic, SDZ_MAGIC, SDZ_MAGIC_SIZE) == 0);
+  close (f);
+  return ret;
+}
+
+int
+sd_compressed_image::open (const char *file)
+{
+  unsigned char raw_header[SDZ_HEADER_SIZE];
+  unsigned char *raw_index;
+  size_t index_size;
+
+  fd = ::open (file, O_RDONLY | O_LARGEFILE);
+  if (fd == -1)
+    {
+      fprintf (stderr, "ArchC: Unable to open SD image %s: %s\n",
+	       file, strerror (errno));
+      return -1;
+    }
+
+  if (pread (fd, raw_header, SDZ_HEADER_SIZE, 0) != SDZ_HEADER_SIZE
+      || memcmp (raw_header, SDZ_MAGIC, SDZ_MAGIC_SIZE) != 0)
+    {
+      fprintf (stderr, "ArchC: %s is not a valid SDZ image\n", file);
+      return -1;
+    }
+  sdz_decode_header (&header, raw_header);
+
+  if (header.chunk_size == 0
+      || header.n_chunks != ((header.image_size + header.chunk_size - 1)
+			     / header.chunk_size))
+    {
+      fprintf (stderr, "ArchC: %s: corrupted SDZ header\n", file);
+      return -1;
+    }
+
+  index_size = header.n_chunks * SDZ_INDEX_ENTRY_SIZE;
+  raw_index = (unsigned char *) malloc (index_size);
+  if (pread (fd, raw_index, index_size, SDZ_HEADER_SIZE)
+      != (ssize_t) index_size)
+    {
+      fprintf (stderr, "ArchC: %s: truncated SDZ index\n", file);
+      free (raw_index);
+      return -1;
+    }
+
+  index = (struct sdz_index_entry *)
+    malloc (header.n_chunks * sizeof (struct sdz_index_entry));
+  for (uint64_t i = 0; i < header.n_chunks; i++)
+    sdz_decode_index_entry (&index[i], raw_index + i * SDZ_INDEX_ENTRY_SIZE);
+  free (raw_index);
+
+  // Worst case zlib expansion of a chunk.
+  zbuf_size = compressBound (header.chunk_size);
+  zbuf = (unsigned char *) malloc (zbuf_size);
+
+  set_cache_size (DEFAULT_CACHE_SIZE);
+
+  fprintf (stderr, "ArchC: SDZ image: %llu bytes in %llu chunks of %u bytes\n",
+	   (unsigned long long) header.image_size,
+	   (unsigned long long) header.n_chunks, header.chunk_size);
+  return 0;
+}
+
+void
+sd_compressed_image::set_cache_size (size_t bytes)
+{
+  max_entries = bytes / header.chunk_size;
+  if (max_entries == 0)
+    max_entries = 1;
+
+  while (cache.size () > max_entries)
+    evict ();
+}
+
+// Drop the least recently used chunk.
+void
+sd_compressed_image::evict ()
+{
+  uint64_t victim = lru.back ();
+  std::map < uint64_t, cache_entry >::iterator it = cache.find (victim);
+
+  free (it->second.data);
+  cache.erase (it);
+  lru.pop_back ();
+}
+
+// Return the inflated contents of CHUNK, which must not be a zero
+// chunk.  The pointer is valid until the next call.
+unsigned char *
+sd_compressed_image::get_chunk (uint64_t chunk)
+{
+  std::map < uint64_t, cache_entry >::iterator it = cache.find (chunk);
+  struct sdz_index_entry *e = &index[chunk];
+  cache_entry entry;
+  uLongf len = header.chunk_size;
+
+  if (it != cache.end ())
+    {
+      hits++;
+      lru.splice (lru.begin (), lru, it->second.lru_pos);
+      return it->second.data;
+    }
+
+  misses++;
+  if (cache.size () >= max_entries)
+    evict ();
+
+  entry.data = (unsigned char *) malloc (header.chunk_size);
+
+  if (e->flags & SDZ_CHUNK_RAW)
+    {
+      if (e->length > header.chunk_size
+	  || pread (fd, entry.data, e->length, e->offset) != (ssize_t) e->length)
+	{
+	  fprintf (stderr, "ArchC: SDZ: unable to read chunk %llu\n",
+		   (unsigned long long) chunk);
+	  free (entry.data);
+	  return NULL;
+	}
+    }
+  else
+    {
+      if (e->length > zbuf_size
+	  || pread (fd, zbuf, e->length, e->offset) != (ssize_t) e->length
+	  || uncompress (entry.data, &len, zbuf, e->length) != Z_OK)
+	{
+	  fprintf (stderr, "ArchC: SDZ: unable to inflate chunk %llu\n",
+		   (unsigned long long) chunk);
+	  free (entry.data);
+	  return NULL;
+	}
+    }
+
+  dprintf ("SDZ: loaded chunk %llu\n", (unsigned long long) chunk);
+
+  lru.push_front (chunk);
+  entry.lru_pos = lru.begin ();
+  cache[chunk] = entry;
+  return entry.data;
+}
+
+int
+sd_compressed_image::read (uint64_t offset, unsigned char *buf, size_t len)
+{
+  while (len > 0)
+    {
+      uint64_t chunk = offset / header.chunk_size;
+      size_t skip = offset % header.chunk_size;
+      size_t n = header.chunk_size - skip;
+      if (n > len)
+	n = len;
+
+      if (chunk >= header.n_chunks)
+	return -1;
+
+      if (index[chunk].flags & SDZ_CHUNK_ZERO)
+	{
+	  zero_reads++;
+	  memset (buf, 0, n);
+	}
+      else
+	{
+	  unsigned char *data = get_chunk (chunk);
+	  if (data == NULL)
+	    return -1;
+	  memcpy (buf, data + skip, n);
+	}
+
+      buf += n;
+      offset += n;
+      len -= n;
+    }
+  return 0;
+}
+
+void
+sd_compressed_image::prefetch (uint64_t offset, size_t len)
+{
+  uint64_t first = offset / header.chunk_size;
+  uint64_t last = (offset + len - 1) / header.chunk_size;
+
+  for (uint64_t i = first; i <= last && i < header.n_chunks; i++)
+    {
+      if ((index[i].flags & SDZ_CHUNK_ZERO) || cache.count (i))
+	continue;
+
+      posix_fadvise (fd, index[i].offset, index[i].length,
+		     POSIX_FADV_WILLNEED);
+    }
+}
+
+void
+sd_compressed_image::print_stats (FILE *stream) const
+{
+  fprintf (stream, "ArchC: SDZ cache: %llu hits, %llu misses, "
+	   "%llu zero chunk reads\n", (unsigned long long) hits,
+	   (unsigned long long) misses, (unsigned long long) zero_reads);
+}
@@ -0,0 +1,95 @@
+// 'sd_compressed.h' - Backend for compressed SD card images
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SD_COMPRESSED_H
+#define SD_COMPRESSED_H
+
+#include "sdz_format.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <list>
+#include <map>
+
+// Read-only access to an SDZ image (see sdz_format.h).  Chunks are
+// inflated on demand and kept in a bounded LRU cache.  Zero chunks are
+// never cached, they are just memset on the caller buffer.
+
+class sd_compressed_image
+{
+public:
+
+  static const size_t DEFAULT_CACHE_SIZE = 8 * 1024 * 1024;
+
+  sd_compressed_image ();
+  ~sd_compressed_image ();
+
+  // Whether FILE starts with the SDZ magic.
+  static bool is_compressed (const char *file);
+
+  // Open FILE and load its index.  Returns 0 on success and -1 on
+  // failure.
+  int open (const char *file);
+
+  // Copy LEN bytes at OFFSET of the uncompressed image to BUF.
+  // Returns 0 on success and -1 on failure.
+  int read (uint64_t offset, unsigned char *buf, size_t len);
+
+  // Hint the host kernel that the data of chunks covering LEN bytes at
+  // OFFSET will be needed soon.
+  void prefetch (uint64_t offset, size_t len);
+
+  // Bound the cache to roughly BYTES of uncompressed data.
+  void set_cache_size (size_t bytes);
+
+  size_t size () const
+  {
+    return header.image_size;
+  }
+
+  void print_stats (FILE *stream) const;
+
+private:
+
+  struct cache_entry
+  {
+    unsigned char *data;
+    std::list < uint64_t >::iterator lru_pos;
+  };
+
+  int fd;
+  struct sdz_header header;
+  struct sdz_index_entry *index;
+
+  // Most recently used chunks in front.
+  std::map < uint64_t, cache_entry > cache;
+  std::list < uint64_t > lru;
+  size_t max_entries;
+
+  // Scratch buffer for compressed data.
+  unsigned char *zbuf;
+  size_t zbuf_size;
+
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t zero_reads;
+
+  unsigned char *get_chunk (uint64_t chunk);
+  void evict ();
+};
+
+#endif // !SD_COMPRESSED_H.
@@ -0,0 +1,315 @@
+// 'sd_overlay.cpp' - Copy-on-write overlay for SD card images
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "sd_overlay.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+
+extern bool DEBUG_SD;
+#define dprintf(args...) if(DEBUG_SD){fprintf(stderr,args);}
+
+sd_overlay::sd_overlay ():
+fd (-1), map_fd (-1), size (0), n_dirty (0), in_memory (false)
+{
+}
+
+sd_overlay::~sd_overlay ()
+{
+  if (fd != -1)
+    close (fd);
+  if (map_fd != -1)
+    close (map_fd);
+}
+
+int
+sd_overlay::open (const char *file, size_t size, bool discard)
+{
+  uint64_t n_chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  this->size = size;
+  dirty.assign (n_chunks, false);
+  n_dirty = 0;
+
+  if (file == NULL)
+    {
+      // Anonymous overlay.  Unlink it right away so it vanishes with
+      // the process, whatever the way we exit.
+      const char *tmpdir = getenv ("TMPDIR");
+      std::string path = std::string (tmpdir ? tmpdir : "/tmp")
+        + "/armsim-sd-XXXXXX";
+      char *name = strdup (path.c_str ());
+
+      fd = mkstemp (name);
+      if (fd == -1)
+        {
+          fprintf (stderr, "ArchC: Unable to create SD overlay %s: %s\n",
+                   name, strerror (errno));
+          free (name);
+          return -1;
+        }
+      unlink (name);
+      free (name);
+    }
+  else
+    {
+      std::string map_name = std::string (file) + ".map";
+      int flags = O_RDWR | O_CREAT | O_LARGEFILE;
+
+      if (discard)
+        flags |= O_TRUNC;
+
+      fd = ::open (file, flags, 0644);
+      if (fd == -1)
+        {
+          fprintf (stderr, "ArchC: Unable to open SD overlay %s: %s\n",
+                   file, strerror (errno));
+          return -1;
+        }
+
+      map_fd = ::open (map_name.c_str (), flags, 0644);
+      if (map_fd == -1)
+        {
+          fprintf (stderr, "ArchC: Unable to open SD overlay map %s: %s\n",
+                   map_name.c_str (), strerror (errno));
+          return -1;
+        }
+
+      if (check_size (file, map_name.c_str ()) != 0)
+        return -1;
+
+      if (load_map () != 0)
+        return -1;
+    }
+
+  // Size the overlay like the (chunk aligned) image, and the map like
+  // its bitmap, so the next run can tell which image they were made
+  // for.  Unwritten chunks are holes, so this costs no disk space.
+  if (ftruncate (fd, n_chunks * CHUNK_SIZE) != 0
+      || (map_fd != -1 && ftruncate (map_fd, (n_chunks + 7) / 8) != 0))
+    {
+      fprintf (stderr, "ArchC: Unable to resize SD overlay: %s\n",
+               strerror (errno));
+      return -1;
+    }
+
+  if (n_dirty)
+    fprintf (stderr, "ArchC: SD overlay %s has %llu dirty chunks\n",
+             file, (unsigned long long) n_dirty);
+  return 0;
+}
+
+// A named overlay left by an earlier run must have been made for an
+// image of this size.  Chunks from another image would be applied to
+// this one.
+int
+sd_overlay::check_size (const char *file, const char *map_name)
+{
+  struct stat st, map_st;
+
+  if (fstat (fd, &st) != 0 || fstat (map_fd, &map_st) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to stat SD overlay %s: %s\n",
+               file, strerror (errno));
+      return -1;
+    }
+
+  // Both empty: a new overlay.
+  if (st.st_size == 0 && map_st.st_size == 0)
+    return 0;
+
+  if ((uint64_t) st.st_size != dirty.size () * CHUNK_SIZE
+      || (uint64_t) map_st.st_size != (dirty.size () + 7) / 8)
+    {
+      fprintf (stderr, "ArchC: SD overlay %s (or %s) was made for an image "
+               "of another size; use --sd-discard to drop it\n", file,
+               map_name);
+      return -1;
+    }
+  return 0;
+}
+
+// Rebuild the dirty bitmap from the sidecar map of a named overlay.
+int
+sd_overlay::load_map ()
+{
+  size_t map_size = (dirty.size () + 7) / 8;
+  unsigned char *map = (unsigned char *) calloc (map_size, 1);
+
+  if (pread (map_fd, map, map_size, 0) < 0)
+    {
+      fprintf (stderr, "ArchC: Unable to read SD overlay map: %s\n",
+               strerror (errno));
+      free (map);
+      return -1;
+    }
+
+  for (uint64_t i = 0; i < dirty.size (); i++)
+    if (map[i / 8] & (1 << (i % 8)))
+      {
+        dirty[i] = true;
+        n_dirty++;
+      }
+
+  free (map);
+  return 0;
+}
+
+int
+sd_overlay::read_chunk (uint64_t chunk, void *buf)
+{
+  std::map<uint64_t, std::vector<unsigned char> >::iterator it =
+    memory_chunks.find (chunk);
+
+  if (it != memory_chunks.end ())
+    {
+      memcpy (buf, &it->second[0], CHUNK_SIZE);
+      return 0;
+    }
+
+  if (pread (fd, buf, CHUNK_SIZE, chunk * CHUNK_SIZE) != CHUNK_SIZE)
+    {
+      fprintf (stderr, "ArchC: SD overlay read of chunk %llu failed: %s\n",
+               (unsigned long long) chunk, strerror (errno));
+      return -1;
+    }
+  return 0;
+}
+
+int
+sd_overlay::write_chunk (uint64_t chunk, const void *buf)
+{
+  if (in_memory)
+    {
+      const unsigned char *bytes = (const unsigned char *) buf;
+
+      memory_chunks[chunk].assign (bytes, bytes + CHUNK_SIZE);
+      if (!dirty[chunk])
+        {
+          dirty[chunk] = true;
+          n_dirty++;
+        }
+      return 0;
+    }
+
+  if (pwrite (fd, buf, CHUNK_SIZE, chunk * CHUNK_SIZE) != CHUNK_SIZE)
+    {
+      fprintf (stderr, "ArchC: SD overlay write of chunk %llu failed: %s\n",
+               (unsigned long long) chunk, strerror (errno));
+      return -1;
+    }
+
+  if (dirty[chunk])
+    return 0;
+
+  dprintf ("SD overlay: chunk %llu is now dirty\n",
+           (unsigned long long) chunk);
+
+  dirty[chunk] = true;
+  n_dirty++;
+
+  // The data is already in the overlay, so updating the map last keeps
+  // it consistent even if we get killed in between.
+  if (map_fd != -1)
+    {
+      unsigned char byte = 0;
+      uint64_t first = chunk & ~7ULL;
+
+      for (uint64_t i = first; i < first + 8 && i < dirty.size (); i++)
+        if (dirty[i])
+          byte |= 1 << (i - first);
+
+      if (pwrite (map_fd, &byte, 1, chunk / 8) != 1)
+        {
+          fprintf (stderr, "ArchC: Unable to update SD overlay map: %s\n",
+                   strerror (errno));
+          return -1;
+        }
+    }
+  return 0;
+}
+
+int
+sd_overlay::commit (const char *base_file)
+{
+  unsigned char buf[CHUNK_SIZE];
+  int base;
+
+  if (n_dirty == 0)
+    return 0;
+
+  base = ::open (base_file, O_WRONLY | O_LARGEFILE);
+  if (base == -1)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s for commit: %s\n",
+               base_file, strerror (errno));
+      return -1;
+    }
+
+  for (uint64_t i = 0; i < dirty.size (); i++)
+    {
+      if (!dirty[i])
+        continue;
+
+      uint64_t offset = i * CHUNK_SIZE;
+      size_t len = (size - offset < CHUNK_SIZE) ? size - offset : CHUNK_SIZE;
+
+      if (read_chunk (i, buf) != 0
+          || pwrite (base, buf, len, offset) != (ssize_t) len)
+        {
+          fprintf (stderr, "ArchC: SD overlay commit to %s failed: %s\n",
+                   base_file, strerror (errno));
+          close (base);
+          return -1;
+        }
+    }
+
+  fsync (base);
+  close (base);
+
+  fprintf (stderr, "ArchC: Committed %llu SD overlay chunks to %s\n",
+           (unsigned long long) n_dirty, base_file);
+
+  clear ();
+  return 0;
+}
+
+// Drop every chunk of the overlay.
+void
+sd_overlay::clear ()
+{
+  uint64_t n_chunks = dirty.size ();
+
+  dirty.assign (n_chunks, false);
+  n_dirty = 0;
+
+  // Punch everything out and restore the original size.
+  if (ftruncate (fd, 0) != 0 || ftruncate (fd, n_chunks * CHUNK_SIZE) != 0)
+    fprintf (stderr, "ArchC: Unable to clear SD overlay: %s\n",
+             strerror (errno));
+
+  if (map_fd != -1 && (ftruncate (map_fd, 0) != 0
+                       || ftruncate (map_fd, (n_chunks + 7) / 8) != 0))
+    fprintf (stderr, "ArchC: Unable to clear SD overlay map: %s\n",
+             strerror (errno));
+}
@@ -0,0 +1,101 @@
+// 'sd_overlay.h' - Copy-on-write overlay for SD card images
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SD_OVERLAY_H
+#define SD_OVERLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <vector>
+
+// Writes issued by the guest to the SD card never touch the base
+// image.  Instead, the first write to a chunk copies it to a sparse
+// overlay file and every later access to that chunk is served from
+// there.  This keeps the base image read-only, so several simulator
+// instances can share it.
+//
+// An overlay may be anonymous (an unlinked temporary file, thrown away
+// at exit) or named.  A named overlay keeps a '<file>.map' sidecar
+// with one bit per chunk, so it survives across runs until it is
+// explicitly committed back to the base image or discarded.
+
+class sd_overlay
+{
+public:
+
+  // Copy-on-write granularity, in bytes.
+  static const uint32_t CHUNK_SIZE = 4096;
+
+  sd_overlay ();
+  ~sd_overlay ();
+
+  // Create or reopen the overlay for an image of SIZE bytes.  FILE may
+  // be NULL for an anonymous overlay.  If DISCARD is set, previous
+  // contents of a named overlay are dropped; otherwise they must have
+  // been made for an image of the same size.  Returns 0 on success and
+  // -1 on failure.
+  int open (const char *file, size_t size, bool discard);
+
+  bool is_dirty (uint64_t chunk) const
+  {
+    return chunk < dirty.size () && dirty[chunk];
+  }
+
+  uint64_t chunks () const
+  {
+    return dirty.size ();
+  }
+
+  // Read/write a whole chunk from/to the overlay file.  Writing a
+  // chunk marks it dirty.  Both return 0 on success and -1 on failure.
+  int read_chunk (uint64_t chunk, void *buf);
+  int write_chunk (uint64_t chunk, const void *buf);
+
+  // Copy every dirty chunk back to BASE_FILE and empty the overlay.
+  int commit (const char *base_file);
+
+  // Keep later writes in memory, out of the overlay file.  For forked
+  // processes, which share the file with their parent.
+  void keep_private ()
+  {
+    in_memory = true;
+  }
+
+  uint64_t dirty_chunks () const
+  {
+    return n_dirty;
+  }
+
+private:
+
+  int fd;
+  int map_fd;
+  size_t size;
+
+  std::vector<bool> dirty;
+  uint64_t n_dirty;
+
+  bool in_memory;
+  std::map<uint64_t, std::vector<unsigned char> > memory_chunks;
+
+  int check_size (const char *file, const char *map_name);
+  int load_map ();
+  void clear ();
+};
+
+#endif // !SD_OVERLAY_H.
@@ -0,0 +1,131 @@
+// 'sdz_format.h' - Compressed SD card image format
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SDZ_FORMAT_H
+#define SDZ_FORMAT_H
+
+#include <stdint.h>
+#include <string.h>
+
+// An SDZ image splits a raw card image in fixed size chunks, each one
+// compressed on its own with zlib, so any chunk can be read without
+// touching the others.  The file layout is:
+//
+//   struct sdz_header
+//   struct sdz_index_entry [n_chunks]
+//   chunk data
+//
+// All fields are little-endian, with no padding, whatever the host:
+// the structs below are only the unpacked form, and go through
+// sdz_{encode,decode}_* to and from the file.  All-zero chunks have no
+// data at all.  This header is shared by the simulator and the sdzip
+// tool, so it must stay valid C.
+
+#define SDZ_MAGIC "ARMSDZ\0\1"
+#define SDZ_MAGIC_SIZE 8
+
+#define SDZ_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+// Chunk flags.
+#define SDZ_CHUNK_ZERO 0x1	// Chunk is all zeros, no data stored.
+#define SDZ_CHUNK_RAW 0x2	// Chunk is stored uncompressed.
+
+struct sdz_header
+{
+  char magic[SDZ_MAGIC_SIZE];
+  uint32_t chunk_size;
+  uint32_t reserved;
+  uint64_t image_size;
+  uint64_t n_chunks;
+};
+
+struct sdz_index_entry
+{
+  uint64_t offset;		// Offset of chunk data in the file.
+  uint32_t length;		// Length of stored data.
+  uint32_t flags;
+};
+
+// Sizes on disk.
+#define SDZ_HEADER_SIZE 32
+#define SDZ_INDEX_ENTRY_SIZE 16
+
+static inline void
+sdz_put32 (unsigned char *p, uint32_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static inline void
+sdz_put64 (unsigned char *p, uint64_t v)
+{
+  sdz_put32 (p, (uint32_t) v);
+  sdz_put32 (p + 4, (uint32_t) (v >> 32));
+}
+
+static inline uint32_t
+sdz_get32 (const unsigned char *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline uint64_t
+sdz_get64 (const unsigned char *p)
+{
+  return sdz_get32 (p) | ((uint64_t) sdz_get32 (p + 4) << 32);
+}
+
+static inline void
+sdz_encode_header (unsigned char *p, const struct sdz_header *h)
+{
+  memcpy (p, h->magic, SDZ_MAGIC_SIZE);
+  sdz_put32 (p + 8, h->chunk_size);
+  sdz_put32 (p + 12, h->reserved);
+  sdz_put64 (p + 16, h->image_size);
+  sdz_put64 (p + 24, h->n_chunks);
+}
+
+static inline void
+sdz_decode_header (struct sdz_header *h, const unsigned char *p)
+{
+  memcpy (h->magic, p, SDZ_MAGIC_SIZE);
+  h->chunk_size = sdz_get32 (p + 8);
+  h->reserved = sdz_get32 (p + 12);
+  h->image_size = sdz_get64 (p + 16);
+  h->n_chunks = sdz_get64 (p + 24);
+}
+
+static inline void
+sdz_encode_index_entry (unsigned char *p, const struct sdz_index_entry *e)
+{
+  sdz_put64 (p, e->offset);
+  sdz_put32 (p + 8, e->length);
+  sdz_put32 (p + 12, e->flags);
+}
+
+static inline void
+sdz_decode_index_entry (struct sdz_index_entry *e, const unsigned char *p)
+{
+  e->offset = sdz_get64 (p);
+  e->length = sdz_get32 (p + 8);
+  e->flags = sdz_get32 (p + 12);
+}
+
+#endif // !SDZ_FORMAT_H.
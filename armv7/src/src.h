@@ -29,12 +29,13 @@
 #include <ac_tlm_protocol.H>
 #include "tzic.h"
 #include "pins.h"
+#include "checkpoint.h"
 #include <stdint.h>		// define types uint32_t, etc
 
 // This represents a generic SRC device used in the ARM SoC by
 // Freescale iMX35.
 
-class src_module:public sc_module, public peripheral
+class src_module:public sc_module, public peripheral, public checkpointable
 {
 private:
   tzic_module & tzic;
@@ -77,6 +78,11 @@ public:
   {
     fast_write (address, datum);
   }
+
+  void checkpoint_state (checkpoint & c)
+  {
+    c.io (regs);
+  }
 };
 
 #endif
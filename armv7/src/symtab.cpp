@@ -0,0 +1,171 @@
+// 'symtab.cpp' - Symbol lookup on guest ELF images
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "symtab.h"
+
+#include <elf.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+int
+symbol_table::load (const char *file)
+{
+  FILE *f = fopen (file, "rb");
+  unsigned char *image;
+  Elf32_Ehdr *ehdr;
+  Elf32_Shdr *shdr;
+  long size;
+  size_t before = symbols.size ();
+
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to open %s: %s\n", file,
+	       strerror (errno));
+      return -1;
+    }
+
+  fseek (f, 0, SEEK_END);
+  size = ftell (f);
+  fseek (f, 0, SEEK_SET);
+
+  image = (unsigned char *) malloc (size);
+  if (size < (long) sizeof (Elf32_Ehdr)
+      || fread (image, 1, size, f) != (size_t) size)
+    {
+      fprintf (stderr, "ArchC: Unable to read %s\n", file);
+      free (image);
+      fclose (f);
+      return -1;
+    }
+  fclose (f);
+
+  ehdr = (Elf32_Ehdr *) image;
+  if (memcmp (ehdr->e_ident, ELFMAG, SELFMAG) != 0
+      || ehdr->e_ident[EI_CLASS] != ELFCLASS32
+      || ehdr->e_ident[EI_DATA] != ELFDATA2LSB
+      || ehdr->e_shoff + (uint64_t) ehdr->e_shnum * sizeof (Elf32_Shdr)
+      > (uint64_t) size)
+    {
+      fprintf (stderr, "ArchC: %s is not a 32-bit little-endian ELF\n",
+	       file);
+      free (image);
+      return -1;
+    }
+
+  shdr = (Elf32_Shdr *) (image + ehdr->e_shoff);
+  for (int i = 0; i < ehdr->e_shnum; i++)
+    {
+      if (shdr[i].sh_type != SHT_SYMTAB || shdr[i].sh_link >= ehdr->e_shnum)
+	continue;
+
+      Elf32_Sym *sym = (Elf32_Sym *) (image + shdr[i].sh_offset);
+      Elf32_Shdr *strtab = &shdr[shdr[i].sh_link];
+      const char *strings = (const char *) (image + strtab->sh_offset);
+      unsigned n = shdr[i].sh_size / sizeof (Elf32_Sym);
+
+      if (shdr[i].sh_offset + shdr[i].sh_size > (uint32_t) size
+	  || strtab->sh_offset + strtab->sh_size > (uint32_t) size)
+	continue;
+
+      for (unsigned j = 0; j < n; j++)
+	{
+	  int type = ELF32_ST_TYPE (sym[j].st_info);
+	  symbol s;
+
+	  if ((type != STT_FUNC && type != STT_NOTYPE)
+	      || sym[j].st_shndx == SHN_UNDEF || sym[j].st_shndx >= SHN_LORESERVE
+	      || sym[j].st_name >= strtab->sh_size)
+	    continue;
+
+	  // Skip the ARM mapping symbols ($a, $d, $t).
+	  s.name = strings + sym[j].st_name;
+	  if (s.name.empty () || s.name[0] == '$')
+	    continue;
+
+	  s.addr = sym[j].st_value & ~1;
+	  s.size = sym[j].st_size;
+	  s.file = files.size ();
+	  s.code = sym[j].st_shndx < ehdr->e_shnum
+	    && (shdr[sym[j].st_shndx].sh_flags & SHF_EXECINSTR);
+	  symbols.push_back (s);
+	}
+    }
+
+  free (image);
+  files.push_back (file);
+  sorted = false;
+
+  fprintf (stderr, "ArchC: Loaded %u symbols from %s\n",
+	   (unsigned) (symbols.size () - before), file);
+  return 0;
+}
+
+void
+symbol_table::sort ()
+{
+  if (!sorted)
+    {
+      std::stable_sort (symbols.begin (), symbols.end ());
+      sorted = true;
+    }
+}
+
+const std::vector < symbol_table::symbol > &
+symbol_table::all ()
+{
+  sort ();
+  return symbols;
+}
+
+const char *
+symbol_table::lookup (uint32_t addr, uint32_t * offset)
+{
+  std::vector < symbol >::iterator it;
+  symbol key;
+
+  sort ();
+
+  // Last symbol starting at or before ADDR.
+  key.addr = addr;
+  it = std::upper_bound (symbols.begin (), symbols.end (), key);
+  if (it == symbols.begin ())
+    return NULL;
+  --it;
+
+  if (it->size && addr - it->addr >= it->size)
+    return NULL;
+
+  if (offset)
+    *offset = addr - it->addr;
+  return it->name.c_str ();
+}
+
+std::string
+symbol_table::name (uint32_t addr)
+{
+  const char *sym = lookup (addr);
+  char buf[16];
+
+  if (sym)
+    return sym;
+
+  snprintf (buf, sizeof (buf), "0x%08x", addr);
+  return buf;
+}
@@ -0,0 +1,84 @@
+// 'symtab.h' - Symbol lookup on guest ELF images
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Address to name translation for code running on the platform.  Symbol
+// tables of any number of 32-bit little-endian ELF files (dumboot.elf,
+// dummyos knrl, ...) can be merged.  Images are expected at their link
+// addresses.
+class symbol_table
+{
+public:
+
+  symbol_table ():sorted (true)
+  {
+  }
+
+  // Add the symbols of ELF file FILE.  Returns 0 on success and -1 on
+  // failure.
+  int load (const char *file);
+
+  // Name of the symbol containing ADDR, or NULL if there is none.  The
+  // distance from the symbol start is stored in OFFSET.
+  const char *lookup (uint32_t addr, uint32_t * offset = NULL);
+
+  // Same as lookup, but always returns a printable name.
+  std::string name (uint32_t addr);
+
+  bool empty () const
+  {
+    return symbols.empty ();
+  }
+
+  struct symbol
+  {
+    uint32_t addr;
+    uint32_t size;
+    std::string name;
+    unsigned file;		// ELF it came from.
+    bool code;			// In an executable section.
+
+    bool operator< (const symbol & other) const
+    {
+      return addr < other.addr;
+    }
+  };
+
+  // All symbols, sorted by address.
+  const std::vector < symbol > &all ();
+
+  const std::string & file_name (unsigned file) const
+  {
+    return files[file];
+  }
+
+private:
+
+  std::vector < symbol > symbols;
+  std::vector < std::string > files;
+  bool sorted;
+
+  void sort ();
+};
+
+#endif // !SYMTAB_H.
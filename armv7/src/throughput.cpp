@@ -0,0 +1,142 @@
+// 'throughput.cpp' - Simulation throughput meter
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "throughput.h"
+#include "quantum.h"
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+
+extern quantum_keeper *qkeeper;
+
+static double
+host_time ()
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Simulated seconds, as seen by the core.
+static double
+sim_time ()
+{
+  if (qkeeper)
+    return qkeeper->get_current_time ().to_seconds ();
+  return sc_time_stamp ().to_seconds ();
+}
+
+throughput_meter::throughput_meter ():
+interval (0), output (NULL), batches (0), start_time (0), last_time (0),
+last_instructions (0)
+{
+}
+
+void
+throughput_meter::start ()
+{
+  start_time = last_time = host_time ();
+}
+
+void
+throughput_meter::check (uint64_t instructions, uint32_t pc)
+{
+  double now = host_time ();
+  double mips, avg_mips;
+
+  if (now - last_time < interval)
+    return;
+
+  mips = (instructions - last_instructions) / (now - last_time) / 1e6;
+  avg_mips = instructions / (now - start_time) / 1e6;
+  last_time = now;
+  last_instructions = instructions;
+
+  if (write_progress (now, mips, avg_mips, instructions, pc,
+		      sim_time ()) != 0)
+    interval = 0;
+}
+
+// Returns 0 on success and -1 on failure.
+int
+throughput_meter::write_progress (double now, double mips, double avg_mips,
+				  uint64_t instructions, uint32_t pc,
+				  double sim_seconds)
+{
+  double elapsed = now - start_time;
+  std::string tmp;
+  FILE *f;
+
+  if (output == NULL)
+    {
+      fprintf (stderr, "ArchC: [%8.1fs] %.2f MIPS (%.2f average), "
+	       "%llu instructions, PC=0x%08x, simulated %.6fs\n", elapsed,
+	       mips, avg_mips, (unsigned long long) instructions, pc,
+	       sim_seconds);
+      return 0;
+    }
+
+  // Readers must never see half a report.
+  tmp = std::string (output) + ".tmp";
+  f = fopen (tmp.c_str (), "w");
+  if (f == NULL)
+    {
+      fprintf (stderr, "ArchC: Unable to write progress to %s: %s\n",
+	       tmp.c_str (), strerror (errno));
+      return -1;
+    }
+
+  fprintf (f, "{\n  \"timestamp\": %lu,\n  \"host_seconds\": %.3f,\n",
+	   (unsigned long) time (NULL), elapsed);
+  fprintf (f, "  \"instructions\": %llu,\n  \"mips\": %.3f,\n"
+	   "  \"average_mips\": %.3f,\n", (unsigned long long) instructions,
+	   mips, avg_mips);
+  fprintf (f, "  \"pc\": %u,\n  \"sim_seconds\": %.9f,\n"
+	   "  \"sim_host_ratio\": %.6f\n}\n", pc, sim_seconds,
+	   elapsed > 0 ? sim_seconds / elapsed : 0.0);
+
+  if (fclose (f) != 0 || rename (tmp.c_str (), output) != 0)
+    {
+      fprintf (stderr, "ArchC: Unable to write progress to %s: %s\n",
+	       output, strerror (errno));
+      return -1;
+    }
+  return 0;
+}
+
+void
+throughput_meter::print_stats (FILE * stream, uint64_t instructions)
+{
+  double elapsed = host_time () - start_time;
+  double sim_seconds = sim_time ();
+
+  // Not started yet.
+  if (start_time == 0 || elapsed <= 0)
+    return;
+
+  fprintf (stream, "ArchC: Host time: %.3f s, %.2f MIPS\n", elapsed,
+	   instructions / elapsed / 1e6);
+  fprintf (stream, "ArchC: Simulated time: %.6f s, %.6f simulated "
+	   "seconds per host second", sim_seconds, sim_seconds / elapsed);
+  if (sim_seconds > 0)
+    fprintf (stream, " (%.1fx slower than real time)",
+	     elapsed / sim_seconds);
+  fprintf (stream, "\n");
+}
@@ -0,0 +1,74 @@
+// 'throughput.h' - Simulation throughput meter
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef THROUGHPUT_H
+#define THROUGHPUT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Host wall time, instructions per second and simulated to host time
+// ratio of a run.  Besides the final report, it can print a progress
+// line to stderr, or rewrite a JSON file, every few seconds.  Host time
+// is only looked at once every CHECK_BATCHES instruction batches, so
+// progress costs nothing on the dispatch path; a core sleeping in WFI
+// reports nothing until it wakes up.
+class throughput_meter
+{
+public:
+
+  static const unsigned CHECK_BATCHES = 1024;
+
+  throughput_meter ();
+
+  // Report progress every SECONDS of host time, to FILE or, if it is
+  // NULL, to stderr.  Zero seconds disables progress reports.
+  void set_progress (unsigned seconds, const char *file)
+  {
+    interval = seconds;
+    output = file;
+  }
+
+  // The simulation starts now.
+  void start ();
+
+  // Called between instruction batches.
+  void poll (uint64_t instructions, uint32_t pc)
+  {
+    if (interval == 0 || ++batches % CHECK_BATCHES != 0)
+      return;
+    check (instructions, pc);
+  }
+
+  void print_stats (FILE * stream, uint64_t instructions);
+
+private:
+
+  unsigned interval;
+  const char *output;
+  unsigned batches;
+
+  double start_time;
+  double last_time;
+  uint64_t last_instructions;
+
+  void check (uint64_t instructions, uint32_t pc);
+  int write_progress (double now, double mips, double avg_mips,
+		      uint64_t instructions, uint32_t pc, double sim_time);
+};
+
+#endif // !THROUGHPUT_H.
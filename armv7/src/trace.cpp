@@ -0,0 +1,153 @@
+// 'trace.cpp' - Binary execution trace recorder
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <string>
+
+trace_recorder::trace_recorder ():
+stream (NULL), fd (-1), map (NULL), map_size (0), buffer (NULL),
+next (NULL), end (NULL), records (NULL), stream_records (0), cur_pc (0)
+{
+}
+
+trace_recorder::~trace_recorder ()
+{
+  close ();
+}
+
+int
+trace_recorder::open (const char *file, uint64_t ring_records,
+		      const char *const *names, unsigned n_names)
+{
+  struct trace_header header;
+  std::string name_block;
+  size_t offset;
+
+  for (unsigned i = 0; i < n_names; i++)
+    {
+      name_block += names[i];
+      name_block += '\0';
+    }
+  offset = sizeof (header) + name_block.size ();
+  offset = (offset + TRACE_ALIGN - 1) / TRACE_ALIGN * TRACE_ALIGN;
+  name_block.resize (offset - sizeof (header), '\0');
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, TRACE_MAGIC, TRACE_MAGIC_SIZE);
+  header.record_size = sizeof (trace_record);
+  header.names_size = name_block.size ();
+
+  if (ring_records == 0)
+    {
+      // Favor speed, traces compress well anyway.
+      stream = gzopen (file, "wb1");
+      if (stream == NULL
+	  || gzwrite (stream, &header, sizeof (header)) != sizeof (header)
+	  || gzwrite (stream, name_block.data (), name_block.size ())
+	  != (int) name_block.size ())
+	{
+	  fprintf (stderr, "ArchC: Unable to write trace %s\n", file);
+	  return -1;
+	}
+
+      buffer = new trace_record[BUFFER_RECORDS];
+      end = buffer + BUFFER_RECORDS;
+      records = &stream_records;
+    }
+  else
+    {
+      header.flags = TRACE_RING;
+      header.capacity = ring_records;
+      map_size = offset + ring_records * sizeof (trace_record);
+
+      fd = ::open (file, O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd == -1 || ftruncate (fd, map_size) != 0)
+	{
+	  fprintf (stderr, "ArchC: Unable to create trace %s: %s\n", file,
+		   strerror (errno));
+	  return -1;
+	}
+
+      map = mmap (NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (map == MAP_FAILED)
+	{
+	  fprintf (stderr, "ArchC: Unable to map trace %s: %s\n", file,
+		   strerror (errno));
+	  map = NULL;
+	  return -1;
+	}
+
+      memcpy (map, &header, sizeof (header));
+      memcpy ((char *) map + sizeof (header), name_block.data (),
+	      name_block.size ());
+
+      buffer = (trace_record *) ((char *) map + offset);
+      end = buffer + ring_records;
+      records = &((struct trace_header *) map)->records;
+    }
+
+  next = buffer;
+  return 0;
+}
+
+void
+trace_recorder::flush ()
+{
+  if (stream != NULL)
+    {
+      int len = (next - buffer) * sizeof (trace_record);
+
+      if (len && gzwrite (stream, buffer, len) != len)
+	fprintf (stderr, "ArchC: Trace write failed, trace is truncated\n");
+    }
+
+  // Rings simply wrap around.
+  next = buffer;
+}
+
+void
+trace_recorder::close ()
+{
+  if (stream != NULL)
+    {
+      flush ();
+      gzclose (stream);
+      stream = NULL;
+      delete[]buffer;
+    }
+
+  if (map != NULL)
+    {
+      munmap (map, map_size);
+      map = NULL;
+    }
+
+  if (fd != -1)
+    {
+      ::close (fd);
+      fd = -1;
+    }
+
+  buffer = next = end = NULL;
+}
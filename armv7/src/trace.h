@@ -0,0 +1,106 @@
+// 'trace.h' - Binary execution trace recorder
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "trace_format.h"
+
+#include <stddef.h>
+#include <zlib.h>
+
+// Records the execution in the format of trace_format.h, either as a
+// gzip stream of the whole run or as a memory-mapped ring keeping only
+// the last records, which stays readable even if the simulator
+// crashes.  Use tools/trdump to read it.
+class trace_recorder
+{
+public:
+
+  // Records buffered before each gzip write.
+  static const size_t BUFFER_RECORDS = 65536;
+
+  trace_recorder ();
+  ~trace_recorder ();
+
+  // Start a trace in FILE.  With RING_RECORDS, keep only that many
+  // records in a mapped ring instead of streaming.  NAMES holds the
+  // name of each instruction id.  Returns 0 on success and -1 on
+  // failure.
+  int open (const char *file, uint64_t ring_records,
+	    const char *const *names, unsigned n_names);
+
+  void instruction (uint32_t pc, unsigned id, unsigned mode, uint32_t cpsr)
+  {
+    cur_pc = pc;
+    append (pc, 0, cpsr, id, TRACE_INSN, mode);
+  }
+
+  void load (uint32_t addr, uint32_t value, unsigned size)
+  {
+    append (cur_pc, addr, value, 0, TRACE_LOAD, size);
+  }
+
+  void store (uint32_t addr, uint32_t value, unsigned size)
+  {
+    append (cur_pc, addr, value, 0, TRACE_STORE, size);
+  }
+
+  void exception (unsigned type, uint32_t pc, uint32_t vector_base,
+		  uint32_t cpsr)
+  {
+    append (pc, vector_base, cpsr, type, TRACE_EXCEPTION, 0);
+  }
+
+  // Write out what is buffered and close the trace.
+  void close ();
+
+private:
+
+  gzFile stream;
+  int fd;
+  void *map;
+  size_t map_size;
+
+  trace_record *buffer;
+  trace_record *next;
+  trace_record *end;
+
+  // Points to the header in rings, so the count survives a crash.
+  uint64_t *records;
+  uint64_t stream_records;
+
+  uint32_t cur_pc;
+
+  void append (uint32_t pc, uint32_t addr, uint32_t value, unsigned id,
+	       unsigned kind, unsigned info)
+  {
+    next->pc = pc;
+    next->addr = addr;
+    next->value = value;
+    next->id = id;
+    next->kind = kind;
+    next->info = info;
+    (*records)++;
+    if (++next == end)
+      flush ();
+  }
+
+  void flush ();
+};
+
+#endif // !TRACE_H.
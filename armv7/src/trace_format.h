@@ -0,0 +1,76 @@
+// 'trace_format.h' - Binary execution trace format
+//
+// Copyright (C) 2026 The ArchC team.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <stdint.h>
+
+// A trace is a sequence of fixed size records.  Every executed
+// instruction gets one, followed by one per data access it makes and
+// one per exception it raises.  The file layout is:
+//
+//   struct trace_header
+//   instruction names, NUL separated
+//   padding, so records start at a multiple of TRACE_ALIGN
+//   struct trace_record [...]
+//
+// Streamed traces are a gzip file holding the layout above, with
+// 'records' left at zero; they end where the data ends.  Ring traces
+// are a plain file mapped in memory, holding the last 'capacity'
+// records, and 'records' counts every record ever written, so the
+// oldest one lives at index records % capacity once the ring wrapped.
+//
+// All fields are little-endian.  This header is shared by the
+// simulator and the trdump tool, so it must stay valid C.
+
+#define TRACE_MAGIC "ARMTRC\0\1"
+#define TRACE_MAGIC_SIZE 8
+
+#define TRACE_ALIGN 16
+
+// Header flags.
+#define TRACE_RING 0x1
+
+// Record kinds.
+#define TRACE_INSN 0		// id: instruction, info: mode, value: CPSR.
+#define TRACE_LOAD 1		// info: size in bytes.
+#define TRACE_STORE 2		// info: size in bytes.
+#define TRACE_EXCEPTION 3	// id: exception, addr: vector base, value: CPSR.
+
+struct trace_header
+{
+  char magic[TRACE_MAGIC_SIZE];
+  uint32_t record_size;
+  uint32_t flags;
+  uint32_t names_size;		// Names plus padding.
+  uint32_t reserved;
+  uint64_t capacity;
+  uint64_t records;
+};
+
+struct trace_record
+{
+  uint32_t pc;
+  uint32_t addr;
+  uint32_t value;
+  uint16_t id;
+  uint8_t kind;
+  uint8_t info;
+};
+
+#endif // !TRACE_FORMAT_H.
@@ -23,9 +23,12 @@
 
 #include "tzic.h"
 #include "arm_interrupts.h"
+#include "host_profile.h"
+#include "latency.h"
 #include <time.h>
 
 extern bool DEBUG_TZIC;
+extern irq_latency *irq_stats;
 
 #include <stdarg.h>
 static inline int
@@ -51,8 +54,16 @@ tzic_module::prc_tzic ()
 {
   do
     {
-      wait (1, SC_NS);
-      if (!changed)
+      // Interrupt lines are level sensitive, so keep signaling the core
+      // every cycle while something is pending.  Otherwise, sleep until
+      // an input or a register changes.
+      if (pending)
+	wait (1, SC_NS);
+      else
+	wait (update);
+
+      HOST_PROFILE_SCOPE (HP_TZIC);
+      if (!changed && !pending)
 	continue;
       changed = false;
       wakeup_signal = false;
@@ -110,7 +121,7 @@ tzic_module::prc_tzic ()
 		  // deassert DSMINT
 		  *(regs + TZIC_DSMINT / 4) = 0;
 		  wakeup_signal = true;
-		  changed = true;
+		  mark_changed ();
 		}
 	    }
 	}
@@ -149,7 +160,23 @@ tzic_module::prc_tzic ()
 	    }
 	}
 
-      if (has_int && enabled)
+      pending = has_int && enabled;
+
+      // Latency is charged to the lines that make the core take the
+      // IRQ: enabled, above the priority mask, with the TZIC enabled.
+      // A line masked before delivery was never seen by the core.
+      if (irq_stats)
+	for (unsigned w = 0; w < 4; ++w)
+	  {
+	    unsigned driving = enabled ? *(regs + TZIC_PND0 / 4 + w) : 0;
+	    unsigned diff = driving ^ reported[w];
+
+	    for (unsigned b = 0; diff; ++b, diff >>= 1)
+	      if (diff & 1)
+		irq_stats->line (w * 32 + b, (driving >> b) & 1);
+	    reported[w] = driving;
+	  }
+      if (pending)
 	{
 	  ac_tlm_rsp rsp;
 	  ac_tlm_req req;
@@ -176,7 +203,7 @@ tzic_module::interrupt (unsigned intnumber, bool deassert)
     int_in[intnumber / 32] &= ~(1 << (intnumber % 32));
   else
     int_in[intnumber / 32] |= (1 << (intnumber % 32));
-  changed = true;
+  mark_changed ();
 }
 
 unsigned
@@ -221,7 +248,7 @@ tzic_module::fast_read (unsigned address)
 void
 tzic_module::fast_write (unsigned address, unsigned datum)
 {
-  changed = true;
+  mark_changed ();
   switch (address)
     {
     case TZIC_INTCTRL:
@@ -254,7 +281,7 @@ tzic_module::fast_write (unsigned address, unsigned datum)
     case TZIC_ENCLEAR2:
     case TZIC_ENCLEAR3:
       address -= TZIC_ENCLEAR0 - TZIC_ENSET0;
-      *(regs + address / 4) = *(regs + address / 4) | ~datum;
+      *(regs + address / 4) = *(regs + address / 4) & ~datum;
       break;
     case TZIC_ENSET0:
     case TZIC_ENSET1:
@@ -289,3 +316,17 @@ tzic_module::fast_write (unsigned address, unsigned datum)
       *(regs + address / 4) = datum;
     }
 }
+
+void
+tzic_module::checkpoint_state (checkpoint & c)
+{
+  c.io (regs);
+  c.io (enabled);
+  c.io (pending);
+  c.io (int_in);
+  c.io (wakeup_signal);
+
+  // Signal whatever was pending again.
+  if (!c.saving ())
+    mark_changed ();
+}
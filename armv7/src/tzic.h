@@ -29,6 +29,7 @@
 #include "peripheral.h"
 #include <systemc.h>
 #include <ac_tlm_protocol.H>
+#include "checkpoint.h"
 
 // In this model, we mimic the behavior of the TZIC IP for controlling
 // interrupts in the freescale iMX53 SoC. A SystemC thread provides a loop,
@@ -45,7 +46,7 @@
 // CHDFACIE.html
 // (AMBA 3 TrustZone Interrupt Controller (SP890) Technical Overview)
 //
-class tzic_module:public sc_module, public peripheral
+class tzic_module:public sc_module, public peripheral, public checkpointable
 {
 private:
   static const unsigned TZIC_INTCTRL = 0x0;	// Control register
@@ -126,8 +127,20 @@ private:
   bool enabled;
   // Indicates if needs process in this cycle
   bool changed;
+  // Notified when changed is set, so the thread doesn't poll for it
+  sc_event update;
+  // Interrupt signaled to the core in the last cycle
+  bool pending;
+
+  void mark_changed ()
+  {
+    changed = true;
+    update.notify (1, SC_NS);
+  }
   // Hardware interrupts input - asserted signals vector
   unsigned int_in[4];
+  // Lines last reported to irq_stats as driving the core
+  unsigned reported[4];
 
   // Fast read/write don't implement error checking. The bus (or other caller)
   // must ensure the address is valid.
@@ -159,6 +172,8 @@ public:
   // Interrupt input. intnumber goes from 0 to 127
   void interrupt (unsigned intnumber, bool deassert = false);
 
+  void checkpoint_state (checkpoint & c);
+
   SC_HAS_PROCESS (tzic_module);
 
 tzic_module (sc_module_name name_):sc_module (name_)
@@ -175,10 +190,13 @@ tzic_module (sc_module_name name_):sc_module (name_)
     *(regs + TZIC_INTTYPE / 4) = 0x403;
     enabled = false;
     changed = true;
+    pending = false;
     int_in[0] = 0;
     int_in[1] = 0;
     int_in[2] = 0;
     int_in[3] = 0;
+    for (int i = 0; i < 4; ++i)
+      reported[i] = 0;
   }
 };
 
@@ -23,12 +23,14 @@
 
 #include "uart.h"
 #include "arm_interrupts.h"
-#include <sys/time.h>
-#include <sys/types.h>
+#include "quantum.h"
+#include "host_profile.h"
+#include "replay.h"
 #include <termios.h>
-#include <unistd.h>
 
 extern bool DEBUG_UART;
+extern quantum_keeper *qkeeper;
+extern host_input *inputs;
 
 #include <stdarg.h>
 static inline int
@@ -46,10 +48,13 @@ dprintf (const char *format, ...)
 }
 
 static struct termios orig_termios;
+static bool saved_termios = false;
+
 static void
 reset_terminal_mode ()
 {
-  tcsetattr (0, TCSANOW, &orig_termios);
+  if (saved_termios)
+    tcsetattr (0, TCSANOW, &orig_termios);
 }
 
 static void
@@ -58,7 +63,7 @@ set_raw_terminal_mode ()
   struct termios new_termios;
 
   /* take two copies - one for now, one for later */
-  tcgetattr (0, &orig_termios);
+  saved_termios = tcgetattr (0, &orig_termios) == 0;
   memcpy (&new_termios, &orig_termios, sizeof (new_termios));
 
   /* set the new terminal mode */
@@ -77,7 +82,9 @@ sc_module (name_), tzic (tzic_)
 
   do_reset ();
 
-  set_raw_terminal_mode ();
+  // A replay doesn't read the terminal, so it leaves it alone.
+  if (!inputs->replaying ())
+    set_raw_terminal_mode ();
 }
 
 uart_module::~uart_module ()
@@ -85,18 +92,6 @@ uart_module::~uart_module ()
   reset_terminal_mode ();
 }
 
-static bool
-check_if_has_input ()
-{
-  struct timeval tv = { 0L, 0L };
-  fd_set rdset;
-  FD_ZERO (&rdset);
-  FD_SET (0, &rdset);
-  if (select (1, &rdset, NULL, NULL, &tv) == 1)
-    return true;
-  return false;
-}
-
 void
 uart_module::update_flags ()
 {
@@ -143,8 +138,20 @@ uart_module::prc_uart ()
 {
   do
     {
-      wait (1, SC_NS);
+      // Poll the host once per quantum, or right after the core touches
+      // a register.  Register accesses don't move the poll, so its phase
+      // only depends on the time, and checkpoints can keep it.
+      if (sc_time_stamp () >= next_poll)
+	{
+	  sc_time quantum ((double) qkeeper->get_global_quantum (), SC_NS);
+
+	  next_poll = sc_time_stamp () + quantum;
+	  poll.cancel ();
+	  poll.notify (quantum);
+	}
+      wait (poll | activity);
 
+      HOST_PROFILE_SCOPE (HP_UART);
       if (!uart_enabled)
 	continue;
 
@@ -154,19 +161,12 @@ uart_module::prc_uart ()
       if (rxd_enabled)
 	{
 	  unsigned char receive_count = 0;
-	  while (check_if_has_input () && rxd_pointer < 32)
+	  unsigned char c;
+	  while (rxd_pointer < 32 && inputs->get (&c))
 	    {
-	      char c;
-	      if (read (STDIN_FILENO, &c, 1) <= 0)
-		continue;
-	      if (cin.good ())
-		{
-		  if (ws == WS_7BIT)
-		    c &= 0x7F;
-		  rxd_fifo[rxd_pointer++] = c;
-		}
-	      else
-		break;
+	      if (ws == WS_7BIT)
+		c &= 0x7F;
+	      rxd_fifo[rxd_pointer++] = c;
 	      ++receive_count;
 	    }
 	  if (receive_count)
@@ -213,6 +213,19 @@ uart_module::prc_uart ()
   while (1);
 }
 
+uint64_t
+uart_module::next_event_ns ()
+{
+  if (!uart_enabled)
+    return NO_EVENT;
+
+  if ((txd_enabled && txd_pointer > 0)
+      || (rxd_enabled && inputs->pending ()))
+    return 0;
+
+  return NO_EVENT;
+}
+
 unsigned
 uart_module::fast_read (unsigned address)
 {
@@ -229,6 +242,9 @@ uart_module::fast_read (unsigned address)
 	bool brk = false;	// BREAK detected
 	bool prerr = false;	// Parity bit error
 	unsigned data = 0;
+
+	// Reading changes the flags, and so the interrupt line.
+	activity.notify (SC_ZERO_TIME);
 	if (!uart_enabled || !rxd_enabled)
 	  // Should return error
 	  return 0;
@@ -285,6 +301,7 @@ uart_module::fast_read (unsigned address)
 void
 uart_module::fast_write (unsigned address, unsigned datum)
 {
+  activity.notify (SC_ZERO_TIME);
   switch (address)
     {
     case UART_UTXD:
@@ -422,3 +439,114 @@ uart_module::fast_write (unsigned address, unsigned datum)
       *(regs + address / 4) = datum;
     }
 }
+
+void
+uart_module::checkpoint_state (checkpoint & c)
+{
+  c.io (regs);
+  c.io (rxd_fifo);
+  c.io (txd_fifo);
+  c.io (rxd_pointer);
+  c.io (txd_pointer);
+  c.io (uart_enabled);
+  c.io (rxd_enabled);
+  c.io (txd_enabled);
+  c.io (aden);
+  c.io (adbr);
+  c.io (trdyen);
+  c.io (iden);
+  c.io (icd);
+  c.io (rrdyen);
+  c.io (rxdmaen);
+  c.io (iren);
+  c.io (txmptyen);
+  c.io (rtsden);
+  c.io (txdmaen);
+  c.io (atdmaen);
+  c.io (esci);
+  c.io (irts);
+  c.io (ctsc);
+  c.io (cts);
+  c.io (escen);
+  c.io (rtec);
+  c.io (pren);
+  c.io (proe);
+  c.io (stpb);
+  c.io (ws);
+  c.io (rtsen);
+  c.io (aten);
+  c.io (dpec);
+  c.io (dtren);
+  c.io (parerren);
+  c.io (fraerren);
+  c.io (dsr);
+  c.io (dcd);
+  c.io (ri);
+  c.io (adnimp);
+  c.io (rxdsen);
+  c.io (airinten);
+  c.io (awaken);
+  c.io (dtrden);
+  c.io (rxdmuxsel);
+  c.io (invt);
+  c.io (acien);
+  c.io (ctstl);
+  c.io (invr);
+  c.io (eniri);
+  c.io (wken);
+  c.io (iddmaen);
+  c.io (irsc);
+  c.io (lpbyp);
+  c.io (tcen);
+  c.io (bken);
+  c.io (oren);
+  c.io (dren);
+  c.io (txtl);
+  c.io (rfdiv);
+  c.io (dcedte);
+  c.io (rxtl);
+  c.io (parityerr);
+  c.io (rtss);
+  c.io (trdy);
+  c.io (rtsd);
+  c.io (escf);
+  c.io (framerr);
+  c.io (rrdy);
+  c.io (agtim);
+  c.io (dtrd);
+  c.io (rxds);
+  c.io (airint);
+  c.io (awake);
+  c.io (adet);
+  c.io (txfe);
+  c.io (dtrf);
+  c.io (idle);
+  c.io (acst);
+  c.io (ridelt);
+  c.io (riin);
+  c.io (irint);
+  c.io (wake);
+  c.io (dcddelt);
+  c.io (dcdin);
+  c.io (rtsf);
+  c.io (txdc);
+  c.io (brcd);
+  c.io (ore);
+  c.io (rdr);
+
+  // The time left until the next poll.  Restoring it, instead of waking
+  // the thread, runs the restored UART exactly as it ran the first time.
+  uint64_t poll_ns = 0;
+
+  if (c.saving () && next_poll > sc_time_stamp ())
+    poll_ns = (uint64_t) ((next_poll - sc_time_stamp ()).to_seconds () * 1e9
+			  + 0.5);
+  c.io (poll_ns);
+  if (!c.saving ())
+    {
+      activity.cancel ();
+      poll.cancel ();
+      next_poll = sc_time_stamp () + sc_time ((double) poll_ns, SC_NS);
+      poll.notify (sc_time ((double) poll_ns, SC_NS));
+    }
+}
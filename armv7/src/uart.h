@@ -28,8 +28,10 @@
 
 #include "peripheral.h"
 #include "tzic.h"
+#include "idle.h"
 #include <systemc.h>
 #include <ac_tlm_protocol.H>
+#include "checkpoint.h"
 
 // In this model, we mimic the behavior of the UART IP for providing
 // communication with the user and the arm platform+sw. This will be used
@@ -42,7 +44,8 @@
 // More info about this module:
 // Please refer to iMX53 Reference Manual page 4403
 //
-class uart_module:public sc_module, public peripheral
+class uart_module:public sc_module, public peripheral, public idle_source,
+  public checkpointable
 {
 private:
 
@@ -73,6 +76,13 @@ private:
   unsigned rxd_pointer;
   unsigned txd_pointer;
 
+  // Notified on register accesses that need the thread attention.
+  sc_event activity;
+
+  // The once per quantum poll of the host, and when it is due.
+  sc_event poll;
+  sc_time next_poll;
+
   bool uart_enabled;
   bool rxd_enabled;
   bool txd_enabled;
@@ -325,6 +335,12 @@ public:
   // This is the main process to simulate the IP behavior
   void prc_uart ();
 
+  // The UART only changes on its own when there is data to move.
+  uint64_t next_event_ns ();
+
+  // Registers, FIFOs and every decoded control and status bit.
+  void checkpoint_state (checkpoint & c);
+
   // -- External signals
 
   SC_HAS_PROCESS (uart_module);
@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "checkpoint_format.h"
+
+// ckpmerge: Fold a chain of delta checkpoints, written with
+// --checkpoint-interval, into one full checkpoint.
+
+#define MAX_CHAIN 4096
+#define MAX_SECTIONS 256
+
+struct image
+{
+  char *name;
+  const uint8_t *map;
+  size_t size;
+  const struct checkpoint_header *header;
+  const struct checkpoint_section *sections[MAX_SECTIONS];
+};
+
+// A page from one of the images.  ORDER is the position of the image in
+// the chain, newest first.
+struct page_ref
+{
+  uint32_t offset;
+  uint32_t order;
+  const uint8_t *data;
+};
+
+void usage ()
+{
+  fprintf (stderr,"ckpmerge: Checkpoint chain merger\n"
+           "Usage:\n"
+           "        ./ckpmerge -o <output> <checkpoint>\n"
+           "\nOptions:\n"
+           "        -o - Write <checkpoint> and all its parents as one\n"
+           "             full checkpoint to this file.\n"
+           "\nReport bugs to gabriel@krisman.be\n");
+}
+
+int load (struct image *img, const char *file)
+{
+  const uint8_t *p, *limit;
+  struct stat st;
+  void *map;
+  uint32_t i;
+  int fd;
+
+  fd = open (file, O_RDONLY);
+  if (fd < 0 || fstat (fd, &st) != 0)
+    {
+      perror (file);
+      if (fd >= 0)
+        close (fd);
+      return -1;
+    }
+
+  map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      perror (file);
+      return -1;
+    }
+
+  img->name = strdup (file);
+  img->map = map;
+  img->size = st.st_size;
+  img->header = map;
+
+  if (img->size < sizeof (*img->header)
+      || memcmp (img->header->magic, CHECKPOINT_MAGIC,
+                 CHECKPOINT_MAGIC_SIZE) != 0
+      || img->header->sections > MAX_SECTIONS)
+    {
+      fprintf (stderr, "ckpmerge: %s is not a checkpoint file\n", file);
+      return -1;
+    }
+
+  p = img->map + sizeof (*img->header);
+  limit = img->map + img->size;
+  for (i = 0; i < img->header->sections; i++)
+    {
+      const struct checkpoint_section *s = (const void *) p;
+
+      if ((size_t) (limit - p) < sizeof (*s)
+          || (uint64_t) (limit - p) - sizeof (*s) < s->size
+          || (s->type == CHECKPOINT_PAGES
+              && s->size % sizeof (struct checkpoint_page) != 0))
+        {
+          fprintf (stderr, "ckpmerge: %s is truncated\n", file);
+          return -1;
+        }
+      img->sections[i] = s;
+      p += sizeof (*s) + s->size;
+    }
+  return 0;
+}
+
+static const struct checkpoint_section *find_section (struct image *img,
+                                                      const char *name)
+{
+  uint32_t i;
+
+  for (i = 0; i < img->header->sections; i++)
+    if (strncmp (img->sections[i]->name, name, CHECKPOINT_NAME_SIZE) == 0)
+      return img->sections[i];
+  return NULL;
+}
+
+static int by_offset (const void *a, const void *b)
+{
+  const struct page_ref *x = a, *y = b;
+
+  if (x->offset != y->offset)
+    return x->offset < y->offset ? -1 : 1;
+  return x->order < y->order ? -1 : x->order > y->order;
+}
+
+static int zero_p (const uint8_t *data)
+{
+  uint32_t i;
+
+  for (i = 0; i < CHECKPOINT_PAGE_SIZE; i++)
+    if (data[i] != 0)
+      return 0;
+  return 1;
+}
+
+// Write the pages of section NAME as the chain leaves them: the newest
+// copy of each, and none that ended up zero.
+int merge_pages (struct image *chain, uint32_t length, const char *name,
+                 FILE *f)
+{
+  struct checkpoint_section out;
+  struct page_ref *refs = NULL;
+  size_t count = 0, capacity = 0, i;
+  uint32_t j;
+
+  for (j = 0; j < length; j++)
+    {
+      const struct checkpoint_section *s = find_section (&chain[j], name);
+      const uint8_t *p;
+
+      if (s == NULL || s->type != CHECKPOINT_PAGES)
+        {
+          fprintf (stderr, "ckpmerge: %s has no pages for %s\n",
+                   chain[j].name, name);
+          free (refs);
+          return -1;
+        }
+
+      for (p = (const uint8_t *) (s + 1);
+           p < (const uint8_t *) (s + 1) + s->size;
+           p += sizeof (struct checkpoint_page))
+        {
+          if (count == capacity)
+            {
+              capacity = capacity ? capacity * 2 : 1024;
+              refs = realloc (refs, capacity * sizeof (*refs));
+            }
+          memcpy (&refs[count].offset, p, sizeof (uint32_t));
+          refs[count].order = j;
+          refs[count].data = p + sizeof (uint32_t);
+          count++;
+        }
+    }
+
+  qsort (refs, count, sizeof (*refs), by_offset);
+
+  // Count what's left first, so the section header is written once.
+  memset (&out, 0, sizeof (out));
+  strncpy (out.name, name, CHECKPOINT_NAME_SIZE - 1);
+  out.type = CHECKPOINT_PAGES;
+  for (i = 0; i < count; i++)
+    if ((i == 0 || refs[i].offset != refs[i - 1].offset)
+        && !zero_p (refs[i].data))
+      out.size += sizeof (struct checkpoint_page);
+
+  if (fwrite (&out, sizeof (out), 1, f) != 1)
+    {
+      free (refs);
+      return -1;
+    }
+
+  for (i = 0; i < count; i++)
+    if ((i == 0 || refs[i].offset != refs[i - 1].offset)
+        && !zero_p (refs[i].data)
+        && (fwrite (&refs[i].offset, sizeof (uint32_t), 1, f) != 1
+            || fwrite (refs[i].data, CHECKPOINT_PAGE_SIZE, 1, f) != 1))
+      {
+        free (refs);
+        return -1;
+      }
+
+  free (refs);
+  return 0;
+}
+
+int main (int argc, char **argv)
+{
+  static struct image chain[MAX_CHAIN];
+  struct checkpoint_header header;
+  const char *output = NULL;
+  uint32_t length = 0, i;
+  FILE *f;
+  int opt;
+
+  while ((opt = getopt (argc, argv, "o:h")) != -1)
+    {
+      switch (opt)
+        {
+        case 'o':
+          output = optarg;
+          break;
+        default:
+          usage ();
+          return 1;
+        }
+    }
+
+  if (output == NULL || optind != argc - 1)
+    {
+      usage ();
+      return 1;
+    }
+
+  // Newest first, down to the full checkpoint.
+  if (load (&chain[length++], argv[optind]) != 0)
+    return 1;
+  while (chain[length - 1].header->flags & CHECKPOINT_DELTA)
+    {
+      const struct checkpoint_header *h = chain[length - 1].header;
+      const char *child = chain[length - 1].name;
+      const char *slash = strrchr (child, '/');
+      size_t dir = slash ? slash - child + 1 : 0;
+      char parent[CHECKPOINT_PARENT_SIZE];
+      char *name;
+
+      if (length == MAX_CHAIN)
+        {
+          fprintf (stderr, "ckpmerge: Chain of %s is too long\n",
+                   argv[optind]);
+          return 1;
+        }
+
+      memcpy (parent, h->parent, CHECKPOINT_PARENT_SIZE);
+      parent[CHECKPOINT_PARENT_SIZE - 1] = '\0';
+      name = malloc (dir + strlen (parent) + 1);
+      memcpy (name, child, dir);
+      strcpy (name + dir, parent);
+
+      if (load (&chain[length], name) != 0)
+        return 1;
+      free (name);
+      if (chain[length].header->instructions != h->parent_instructions)
+        {
+          fprintf (stderr, "ckpmerge: %s is not the parent of %s anymore\n",
+                   chain[length].name, child);
+          return 1;
+        }
+      length++;
+    }
+
+  memcpy (&header, chain[0].header, sizeof (header));
+  header.flags &= ~CHECKPOINT_DELTA;
+  header.parent_instructions = 0;
+  memset (header.parent, 0, sizeof (header.parent));
+
+  f = fopen (output, "wb");
+  if (f == NULL || fwrite (&header, sizeof (header), 1, f) != 1)
+    {
+      perror (output);
+      return 1;
+    }
+
+  // Devices keep their state whole in every checkpoint, so the newest
+  // has it all.  Only memories need the rest of the chain.
+  for (i = 0; i < header.sections; i++)
+    {
+      const struct checkpoint_section *s = chain[0].sections[i];
+      int ret;
+
+      if (s->type == CHECKPOINT_PAGES)
+        ret = merge_pages (chain, length, s->name, f);
+      else
+        ret = fwrite (s, sizeof (*s) + s->size, 1, f) != 1 ? -1 : 0;
+
+      if (ret != 0)
+        {
+          fprintf (stderr, "ckpmerge: Unable to merge %.*s into %s\n",
+                   CHECKPOINT_NAME_SIZE, s->name, output);
+          fclose (f);
+          return 1;
+        }
+    }
+
+  if (fclose (f) != 0)
+    {
+      perror (output);
+      return 1;
+    }
+
+  for (i = 0; i < length; i++)
+    {
+      munmap ((void *) chain[i].map, chain[i].size);
+      free (chain[i].name);
+    }
+  return 0;
+}
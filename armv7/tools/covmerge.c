@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "coverage_format.h"
+
+// covmerge: Merge coverage bitmaps recorded with --coverage.
+
+struct page_list
+{
+  struct coverage_page *pages;
+  uint32_t count, capacity;
+};
+
+void usage ()
+{
+  fprintf (stderr,"covmerge: Coverage bitmap merger\n"
+           "Usage:\n"
+           "        ./covmerge -o <output> <coverage> [<coverage> ...]\n"
+           "\nOptions:\n"
+           "        -o - Write the union of all inputs to this file.\n"
+           "\nReport bugs to gabriel@krisman.be\n");
+}
+
+static struct coverage_page *find_page (struct page_list *l, uint32_t base)
+{
+  uint32_t i;
+
+  for (i = 0; i < l->count; i++)
+    if (l->pages[i].base == base)
+      return &l->pages[i];
+
+  if (l->count == l->capacity)
+    {
+      l->capacity = l->capacity ? l->capacity * 2 : 64;
+      l->pages = realloc (l->pages, l->capacity * sizeof (*l->pages));
+    }
+
+  memset (&l->pages[l->count], 0, sizeof (*l->pages));
+  l->pages[l->count].base = base;
+  return &l->pages[l->count++];
+}
+
+int merge (struct page_list *l, const char *file)
+{
+  struct coverage_header header;
+  struct coverage_page p;
+  uint32_t i, j;
+  FILE *f = fopen (file, "rb");
+
+  if (f == NULL)
+    {
+      perror (file);
+      return -1;
+    }
+
+  if (fread (&header, sizeof (header), 1, f) != 1
+      || memcmp (header.magic, COVERAGE_MAGIC, COVERAGE_MAGIC_SIZE) != 0
+      || header.page_size != COVERAGE_PAGE_SIZE)
+    {
+      fprintf (stderr, "covmerge: %s is not a coverage file\n", file);
+      fclose (f);
+      return -1;
+    }
+
+  for (i = 0; i < header.pages; i++)
+    {
+      struct coverage_page *dst;
+
+      if (fread (&p, sizeof (p), 1, f) != 1)
+        {
+          fprintf (stderr, "covmerge: %s is truncated\n", file);
+          fclose (f);
+          return -1;
+        }
+
+      dst = find_page (l, p.base);
+      for (j = 0; j < COVERAGE_PAGE_BYTES; j++)
+        dst->bits[j] |= p.bits[j];
+    }
+
+  fclose (f);
+  return 0;
+}
+
+static int by_base (const void *a, const void *b)
+{
+  uint32_t x = ((const struct coverage_page *) a)->base;
+  uint32_t y = ((const struct coverage_page *) b)->base;
+
+  return x < y ? -1 : x > y;
+}
+
+int main (int argc, char **argv)
+{
+  struct page_list l = { NULL, 0, 0 };
+  struct coverage_header header;
+  const char *output = NULL;
+  FILE *f;
+  int opt, i;
+
+  while ((opt = getopt (argc, argv, "o:h")) != -1)
+    {
+      switch (opt)
+        {
+        case 'o':
+          output = optarg;
+          break;
+        default:
+          usage ();
+          return 1;
+        }
+    }
+
+  if (output == NULL || optind == argc)
+    {
+      usage ();
+      return 1;
+    }
+
+  for (i = optind; i < argc; i++)
+    if (merge (&l, argv[i]) != 0)
+      return 1;
+
+  qsort (l.pages, l.count, sizeof (*l.pages), by_base);
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, COVERAGE_MAGIC, COVERAGE_MAGIC_SIZE);
+  header.page_size = COVERAGE_PAGE_SIZE;
+  header.pages = l.count;
+
+  f = fopen (output, "wb");
+  if (f == NULL
+      || fwrite (&header, sizeof (header), 1, f) != 1
+      || fwrite (l.pages, sizeof (*l.pages), l.count, f) != l.count
+      || fclose (f) != 0)
+    {
+      perror (output);
+      return 1;
+    }
+
+  free (l.pages);
+  return 0;
+}
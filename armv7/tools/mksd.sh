@@ -22,6 +22,7 @@ Arguments:
 
         --os <PATH>: Operating System ELF binary Path
         --user <PATH>: User code ELF binary path.
+        --compress: Also write a compressed disk.sdz image.
         --help: Display this message.
 
 Report bugs to gabriel@krisman.be
@@ -84,6 +85,11 @@ while test -n "$1" ; do
             shift 2
             ;;
 
+        "--compress")
+            COMPRESS=1
+            shift
+            ;;
+
         "--help")
             usage
             exit 0
@@ -113,4 +119,9 @@ echo "Generating IVT... Entry is ${SO_ENTRY}"
 ivtgen ${IMG_BEGIN} 1ffff ${SO_ENTRY} \
     | dd of=${DISK} obs=1 seek=$((0x400)) conv=notrunc 2>/dev/null
 
+if test -n "$COMPRESS"; then
+    echo "Compressing disk..."
+    sdzip ${DISK} ${DISK%.img}.sdz || error "Unable to compress disk."
+fi
+
 echo "Disk Ready."
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "sdz_format.h"
+
+// sdzip: Convert raw SD card images to the SDZ format and back.
+
+void usage ()
+{
+  fprintf (stderr,"sdzip: SD card image compressor\n"
+           "Usage:\n"
+           "        ./sdzip [-c <chunk_kib>] <raw_image> <sdz_image>\n"
+           "        ./sdzip -d <sdz_image> <raw_image>\n"
+           "\nOptions:\n"
+           "        -c - Chunk size in KiB (default 64).\n"
+           "        -d - Decompress an SDZ image.\n"
+           "\nReport bugs to gabriel@krisman.be\n");
+}
+
+// Write LEN bytes of BUF, or complain.  Returns 0 on success.
+static int write_all (FILE *out, const void *buf, size_t len)
+{
+  if (len != 0 && fwrite (buf, 1, len, out) != len)
+    {
+      perror ("sdzip: write failed");
+      return 1;
+    }
+  return 0;
+}
+
+// Header and index, in their on-disk form.
+static int write_index (FILE *out, const struct sdz_header *header,
+                        const struct sdz_index_entry *index)
+{
+  unsigned char raw[SDZ_HEADER_SIZE];
+  unsigned char entry[SDZ_INDEX_ENTRY_SIZE];
+  uint64_t i;
+
+  sdz_encode_header (raw, header);
+  if (fseeko (out, 0, SEEK_SET) != 0
+      || write_all (out, raw, SDZ_HEADER_SIZE) != 0)
+    return 1;
+
+  for (i = 0; i < header->n_chunks; i++)
+    {
+      sdz_encode_index_entry (entry, &index[i]);
+      if (write_all (out, entry, SDZ_INDEX_ENTRY_SIZE) != 0)
+        return 1;
+    }
+  return 0;
+}
+
+static int is_zero (const unsigned char *buf, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    if (buf[i])
+      return 0;
+  return 1;
+}
+
+int compress_image (FILE *in, FILE *out, uint32_t chunk_size)
+{
+  struct sdz_header header;
+  struct sdz_index_entry *index;
+  unsigned char *buf, *zbuf;
+  uint64_t i, offset, zeros = 0;
+  uLongf zlen;
+  size_t n;
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, SDZ_MAGIC, SDZ_MAGIC_SIZE);
+  header.chunk_size = chunk_size;
+
+  fseeko (in, 0, SEEK_END);
+  header.image_size = ftello (in);
+  fseeko (in, 0, SEEK_SET);
+  header.n_chunks = (header.image_size + chunk_size - 1) / chunk_size;
+
+  index = calloc (header.n_chunks, sizeof (*index));
+  buf = malloc (chunk_size);
+  zbuf = malloc (compressBound (chunk_size));
+
+  // Chunk data goes right after the index.
+  offset = SDZ_HEADER_SIZE + header.n_chunks * SDZ_INDEX_ENTRY_SIZE;
+  if (fseeko (out, offset, SEEK_SET) != 0)
+    {
+      perror ("sdzip: seek failed");
+      return 1;
+    }
+
+  for (i = 0; i < header.n_chunks; i++)
+    {
+      n = fread (buf, 1, chunk_size, in);
+      if (ferror (in))
+        {
+          perror ("sdzip: read failed");
+          return 1;
+        }
+      memset (buf + n, 0, chunk_size - n);
+
+      if (is_zero (buf, chunk_size))
+        {
+          index[i].flags = SDZ_CHUNK_ZERO;
+          zeros++;
+          continue;
+        }
+
+      zlen = compressBound (chunk_size);
+      if (compress2 (zbuf, &zlen, buf, chunk_size, Z_BEST_COMPRESSION) != Z_OK)
+        {
+          fprintf (stderr, "sdzip: compression failed at chunk %llu\n",
+                   (unsigned long long) i);
+          return 1;
+        }
+
+      index[i].offset = offset;
+      if (zlen >= chunk_size)
+        {
+          index[i].flags = SDZ_CHUNK_RAW;
+          index[i].length = chunk_size;
+          if (write_all (out, buf, chunk_size) != 0)
+            return 1;
+        }
+      else
+        {
+          index[i].length = zlen;
+          if (write_all (out, zbuf, zlen) != 0)
+            return 1;
+        }
+      offset += index[i].length;
+    }
+
+  if (write_index (out, &header, index) != 0)
+    return 1;
+
+  fprintf (stderr, "sdzip: %llu chunks, %llu zero, %llu -> %llu bytes\n",
+           (unsigned long long) header.n_chunks, (unsigned long long) zeros,
+           (unsigned long long) header.image_size,
+           (unsigned long long) offset);
+
+  free (index);
+  free (buf);
+  free (zbuf);
+  return 0;
+}
+
+int decompress_image (FILE *in, FILE *out)
+{
+  unsigned char raw[SDZ_HEADER_SIZE];
+  unsigned char entry[SDZ_INDEX_ENTRY_SIZE];
+  struct sdz_header header;
+  struct sdz_index_entry *index;
+  unsigned char *buf, *zbuf;
+  uint64_t i, left;
+  uLongf len;
+  size_t n;
+
+  if (fread (raw, SDZ_HEADER_SIZE, 1, in) != 1
+      || memcmp (raw, SDZ_MAGIC, SDZ_MAGIC_SIZE) != 0)
+    {
+      fprintf (stderr, "sdzip: not an SDZ image\n");
+      return 1;
+    }
+  sdz_decode_header (&header, raw);
+
+  index = calloc (header.n_chunks, sizeof (*index));
+  buf = malloc (header.chunk_size);
+  zbuf = malloc (compressBound (header.chunk_size));
+  for (i = 0; i < header.n_chunks; i++)
+    {
+      if (fread (entry, SDZ_INDEX_ENTRY_SIZE, 1, in) != 1)
+        {
+          fprintf (stderr, "sdzip: truncated index\n");
+          return 1;
+        }
+      sdz_decode_index_entry (&index[i], entry);
+    }
+
+  left = header.image_size;
+  for (i = 0; i < header.n_chunks; i++)
+    {
+      n = (left < header.chunk_size) ? left : header.chunk_size;
+
+      if (index[i].flags & SDZ_CHUNK_ZERO)
+        memset (buf, 0, header.chunk_size);
+      else
+        {
+          fseeko (in, index[i].offset, SEEK_SET);
+          if (index[i].flags & SDZ_CHUNK_RAW)
+            len = fread (buf, 1, index[i].length, in);
+          else
+            {
+              len = header.chunk_size;
+              if (fread (zbuf, 1, index[i].length, in) != index[i].length
+                  || uncompress (buf, &len, zbuf, index[i].length) != Z_OK)
+                {
+                  fprintf (stderr, "sdzip: corrupted chunk %llu\n",
+                           (unsigned long long) i);
+                  return 1;
+                }
+            }
+        }
+
+      if (write_all (out, buf, n) != 0)
+        return 1;
+      left -= n;
+    }
+
+  free (index);
+  free (buf);
+  free (zbuf);
+  return 0;
+}
+
+int main (int argc, char **argv)
+{
+  uint32_t chunk_kib = SDZ_DEFAULT_CHUNK_SIZE / 1024;
+  int decompress = 0;
+  FILE *in, *out;
+  int opt, ret;
+
+  while ((opt = getopt (argc, argv, "c:dh")) != -1)
+    {
+      switch (opt)
+        {
+        case 'c':
+          sscanf (optarg, "%u", &chunk_kib);
+          break;
+        case 'd':
+          decompress = 1;
+          break;
+        default:
+          usage ();
+          return 1;
+        }
+    }
+
+  if (argc - optind < 2 || chunk_kib == 0)
+    {
+      usage ();
+      return 1;
+    }
+
+  in = fopen (argv[optind], "rb");
+  if (in == NULL)
+    {
+      perror (argv[optind]);
+      return 1;
+    }
+
+  out = fopen (argv[optind + 1], "wb");
+  if (out == NULL)
+    {
+      perror (argv[optind + 1]);
+      return 1;
+    }
+
+  if (decompress)
+    ret = decompress_image (in, out);
+  else
+    ret = compress_image (in, out, chunk_kib * 1024);
+
+  fclose (in);
+  // Buffered data only hits the disk here, so a full disk may only
+  // show up now.
+  if (fclose (out) != 0)
+    {
+      perror (argv[optind + 1]);
+      return 1;
+    }
+  return ret;
+}
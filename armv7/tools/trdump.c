@@ -0,0 +1,356 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "trace_format.h"
+
+// trdump: Print and compare execution traces recorded with --trace.
+
+#define READ_RECORDS 4096
+#define MAX_CONTEXT 1024
+
+struct trace
+{
+  const char *file;
+  gzFile f;
+  struct trace_header header;
+  char *name_block;
+  const char **names;
+  unsigned n_names;
+
+  // Records read ahead, or the whole ring.
+  struct trace_record *buf;
+  uint64_t pos, count;
+
+  // Ring traces only.
+  uint64_t ring_left;
+
+  // Index of the next record in the whole run.
+  uint64_t index;
+};
+
+static const char *exception_names[] = {
+  "reset", "undef", "swi", "pabort", "dabort", "irq", "fiq"
+};
+
+void usage ()
+{
+  fprintf (stderr,"trdump: Execution trace reader\n"
+           "Usage:\n"
+           "        ./trdump [-r <start>:<end>] [-n <records>] <trace>\n"
+           "        ./trdump -d [-r <start>:<end>] [-c <records>] <trace> <trace>\n"
+           "\nOptions:\n"
+           "        -r - Only records with PC in [start, end).\n"
+           "        -n - Stop after printing this many records.\n"
+           "        -d - Report the first difference between two traces.\n"
+           "        -c - Records of context shown before it (default 8).\n"
+           "\nReport bugs to gabriel@krisman.be\n");
+}
+
+static const char *mode_name (unsigned mode)
+{
+  switch (mode)
+    {
+    case 0x10: return "usr";
+    case 0x11: return "fiq";
+    case 0x12: return "irq";
+    case 0x13: return "svc";
+    case 0x17: return "abt";
+    case 0x1B: return "und";
+    case 0x1F: return "sys";
+    }
+  return "???";
+}
+
+int trace_open (struct trace *t, const char *file)
+{
+  unsigned i;
+  char *s;
+
+  memset (t, 0, sizeof (*t));
+  t->file = file;
+
+  // gzread reads uncompressed ring files as they are.
+  t->f = gzopen (file, "rb");
+  if (t->f == NULL)
+    {
+      perror (file);
+      return -1;
+    }
+
+  if (gzread (t->f, &t->header, sizeof (t->header)) != sizeof (t->header)
+      || memcmp (t->header.magic, TRACE_MAGIC, TRACE_MAGIC_SIZE) != 0
+      || t->header.record_size != sizeof (struct trace_record))
+    {
+      fprintf (stderr, "trdump: %s is not a trace\n", file);
+      return -1;
+    }
+
+  t->name_block = malloc (t->header.names_size + 1);
+  if (gzread (t->f, t->name_block, t->header.names_size)
+      != (int) t->header.names_size)
+    {
+      fprintf (stderr, "trdump: %s is truncated\n", file);
+      return -1;
+    }
+  t->name_block[t->header.names_size] = '\0';
+
+  for (s = t->name_block; *s; s += strlen (s) + 1)
+    t->n_names++;
+  t->names = calloc (t->n_names, sizeof (*t->names));
+  for (i = 0, s = t->name_block; i < t->n_names; s += strlen (s) + 1)
+    t->names[i++] = s;
+
+  if (t->header.flags & TRACE_RING)
+    {
+      uint64_t size = t->header.capacity * sizeof (struct trace_record);
+
+      t->buf = malloc (size);
+      if ((uint64_t) gzread (t->f, t->buf, size) != size)
+        {
+          fprintf (stderr, "trdump: %s is truncated\n", file);
+          return -1;
+        }
+
+      // Start from the oldest record still in the ring.
+      t->count = t->header.capacity;
+      if (t->header.records > t->header.capacity)
+        {
+          t->pos = t->header.records % t->header.capacity;
+          t->ring_left = t->header.capacity;
+          t->index = t->header.records - t->header.capacity;
+        }
+      else
+        t->ring_left = t->header.records;
+    }
+  else
+    t->buf = malloc (READ_RECORDS * sizeof (struct trace_record));
+
+  return 0;
+}
+
+// Fetch the next record.  Returns 1 if there is one, 0 at the end.
+int trace_next (struct trace *t, struct trace_record *r)
+{
+  if (t->header.flags & TRACE_RING)
+    {
+      if (t->ring_left == 0)
+        return 0;
+      t->ring_left--;
+      if (t->pos == t->count)
+        t->pos = 0;
+    }
+  else if (t->pos == t->count)
+    {
+      int n = gzread (t->f, t->buf, READ_RECORDS * sizeof (*r));
+
+      if (n <= 0)
+        return 0;
+      t->count = n / sizeof (*r);
+      t->pos = 0;
+      if (t->count == 0)
+        return 0;
+    }
+
+  *r = t->buf[t->pos++];
+  t->index++;
+  return 1;
+}
+
+void trace_close (struct trace *t)
+{
+  if (t->f)
+    gzclose (t->f);
+  free (t->name_block);
+  free (t->names);
+  free (t->buf);
+}
+
+void print_record (FILE *out, const struct trace *t, uint64_t index,
+                   const struct trace_record *r)
+{
+  fprintf (out, "%12llu ", (unsigned long long) index);
+
+  switch (r->kind)
+    {
+    case TRACE_INSN:
+      fprintf (out, "I 0x%08x  %-10s %s cpsr=0x%08x\n", r->pc,
+               r->id < t->n_names ? t->names[r->id] : "?",
+               mode_name (r->info), r->value);
+      break;
+    case TRACE_LOAD:
+      fprintf (out, "L 0x%08x  [0x%08x] -> 0x%08x (%u)\n", r->pc, r->addr,
+               r->value, r->info);
+      break;
+    case TRACE_STORE:
+      fprintf (out, "S 0x%08x  [0x%08x] <- 0x%08x (%u)\n", r->pc, r->addr,
+               r->value, r->info);
+      break;
+    case TRACE_EXCEPTION:
+      fprintf (out, "E 0x%08x  %s vbar=0x%08x cpsr=0x%08x\n", r->pc,
+               r->id < 7 ? exception_names[r->id] : "?", r->addr, r->value);
+      break;
+    default:
+      fprintf (out, "? 0x%08x\n", r->pc);
+    }
+}
+
+static uint32_t range_start = 0, range_end = 0;
+
+static int in_range (const struct trace_record *r)
+{
+  if (range_end == 0)
+    return 1;
+  return r->pc >= range_start && r->pc < range_end;
+}
+
+// Next record within the PC range.
+static int next_in_range (struct trace *t, struct trace_record *r)
+{
+  while (trace_next (t, r))
+    if (in_range (r))
+      return 1;
+  return 0;
+}
+
+int dump (struct trace *t, uint64_t max)
+{
+  struct trace_record r;
+  uint64_t printed = 0;
+
+  while ((max == 0 || printed < max) && next_in_range (t, &r))
+    {
+      print_record (stdout, t, t->index - 1, &r);
+      printed++;
+    }
+  return 0;
+}
+
+// Instruction names may differ between builds, so compare ids only.
+int diff (struct trace *a, struct trace *b, unsigned context)
+{
+  struct trace_record ctx[MAX_CONTEXT];
+  uint64_t ctx_index[MAX_CONTEXT];
+  struct trace_record ra, rb;
+  uint64_t n = 0, i, first;
+  int has_a, has_b;
+
+  for (;;)
+    {
+      has_a = next_in_range (a, &ra);
+      has_b = next_in_range (b, &rb);
+
+      if (!has_a && !has_b)
+        {
+          printf ("Traces match (%llu records)\n", (unsigned long long) n);
+          return 0;
+        }
+
+      if (has_a && has_b && memcmp (&ra, &rb, sizeof (ra)) == 0)
+        {
+          if (context)
+            {
+              ctx[n % context] = ra;
+              ctx_index[n % context] = a->index - 1;
+            }
+          n++;
+          continue;
+        }
+      break;
+    }
+
+  printf ("Traces diverge after %llu matching records\n",
+          (unsigned long long) n);
+
+  first = n > context ? n - context : 0;
+  for (i = first; i < n; i++)
+    {
+      printf ("  ");
+      print_record (stdout, a, ctx_index[i % context], &ctx[i % context]);
+    }
+
+  if (has_a)
+    {
+      printf ("< ");
+      print_record (stdout, a, a->index - 1, &ra);
+    }
+  else
+    printf ("< end of %s\n", a->file);
+
+  if (has_b)
+    {
+      printf ("> ");
+      print_record (stdout, b, b->index - 1, &rb);
+    }
+  else
+    printf ("> end of %s\n", b->file);
+
+  return 1;
+}
+
+int main (int argc, char **argv)
+{
+  unsigned long long max = 0;
+  unsigned context = 8;
+  int do_diff = 0;
+  struct trace a, b;
+  int opt, ret;
+
+  while ((opt = getopt (argc, argv, "c:dn:r:h")) != -1)
+    {
+      switch (opt)
+        {
+        case 'c':
+          sscanf (optarg, "%u", &context);
+          break;
+        case 'd':
+          do_diff = 1;
+          break;
+        case 'n':
+          sscanf (optarg, "%llu", &max);
+          break;
+        case 'r':
+          {
+            char *end;
+
+            range_start = strtoul (optarg, &end, 0);
+            if (*end == ':')
+              range_end = strtoul (end + 1, &end, 0);
+          }
+          if (range_end <= range_start)
+            {
+              usage ();
+              return 1;
+            }
+          break;
+        default:
+          usage ();
+          return 1;
+        }
+    }
+
+  if (argc - optind < (do_diff ? 2 : 1) || context > MAX_CONTEXT)
+    {
+      usage ();
+      return 1;
+    }
+
+  if (trace_open (&a, argv[optind]) != 0)
+    return 1;
+
+  if (do_diff)
+    {
+      if (trace_open (&b, argv[optind + 1]) != 0)
+        return 1;
+      ret = diff (&a, &b, context);
+      trace_close (&b);
+    }
+  else
+    ret = dump (&a, max);
+
+  trace_close (&a);
+  return ret;
+}